@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "container_stats.h"
+
 // ----- Simple chunked deque structure
 template <typename T>
 class MyDeque {
@@ -9,11 +11,23 @@ private:
     static const int CHUNK_SIZE = 4; // small chunk size)
     T** chunks;                      // array of pointers to chunks
     int frontIndex, backIndex;      // chunk boundaries
+    int frontOffset, backOffset;    // first element / one past the last, inside those chunks
     int capacity;                   // number of chunk slots
     int count;                      // number of elements
 
+    T* newChunk() {
+        container_stats::count_allocation<MyDeque>(CHUNK_SIZE * sizeof(T));
+        return new T[CHUNK_SIZE];
+    }
+
+    T** newChunkMap(int slots) {
+        container_stats::count_allocation<MyDeque>(slots * sizeof(T*));
+        return new T*[slots];
+    }
+
     void allocateChunks(int newCapacity) {
-        T** newChunks = new T*[newCapacity];
+        container_stats::count<MyDeque>(container_stats::REGROWTHS);
+        T** newChunks = newChunkMap(newCapacity);
         for (int i = 0; i < newCapacity; ++i)
             newChunks[i] = nullptr;
 
@@ -28,28 +42,32 @@ private:
         capacity = newCapacity;
     }
 
+    // Step to the neighbouring chunk, allocating it unless an earlier pop left it behind
     void ensureFrontSpace() {
         if (frontIndex == 0)
             allocateChunks(capacity * 2);
-        if (!chunks[frontIndex - 1])
-            chunks[--frontIndex] = new T[CHUNK_SIZE];
+        --frontIndex;
+        if (!chunks[frontIndex])
+            chunks[frontIndex] = newChunk();
     }
 
     void ensureBackSpace() {
         if (backIndex == capacity - 1)
             allocateChunks(capacity * 2);
-        if (!chunks[backIndex + 1])
-            chunks[++backIndex] = new T[CHUNK_SIZE];
+        ++backIndex;
+        if (!chunks[backIndex])
+            chunks[backIndex] = newChunk();
     }
 
 public:
     MyDeque() {
         capacity = 8;
-        chunks = new T*[capacity];
+        chunks = newChunkMap(capacity);
         for (int i = 0; i < capacity; ++i)
             chunks[i] = nullptr;
         frontIndex = backIndex = capacity / 2;
-        chunks[frontIndex] = new T[CHUNK_SIZE];
+        frontOffset = backOffset = 0;
+        chunks[frontIndex] = newChunk();
         count = 0;
     }
 
@@ -62,15 +80,18 @@ public:
 
     // Copy constructor ------  new memory
     MyDeque(const MyDeque& other) {
+        container_stats::count<MyDeque>(container_stats::COPIES);
         capacity = other.capacity;
         frontIndex = other.frontIndex;
         backIndex = other.backIndex;
+        frontOffset = other.frontOffset;
+        backOffset = other.backOffset;
         count = other.count;
 
-        chunks = new T*[capacity];
+        chunks = newChunkMap(capacity);
         for (int i = 0; i < capacity; ++i) {
             if (other.chunks[i]) {
-                chunks[i] = new T[CHUNK_SIZE];
+                chunks[i] = newChunk();
                 for (int j = 0; j < CHUNK_SIZE; ++j)
                     chunks[i][j] = other.chunks[i][j];
             } else {
@@ -82,6 +103,7 @@ public:
     // Assignment operator
     MyDeque& operator=(const MyDeque& other) {
         if (this != &other) {
+            container_stats::count<MyDeque>(container_stats::COPIES);
             for (int i = 0; i < capacity; ++i)
                 delete[] chunks[i];
             delete[] chunks;
@@ -89,12 +111,14 @@ public:
             capacity = other.capacity;
             frontIndex = other.frontIndex;
             backIndex = other.backIndex;
+            frontOffset = other.frontOffset;
+            backOffset = other.backOffset;
             count = other.count;
 
-            chunks = new T*[capacity];
+            chunks = newChunkMap(capacity);
             for (int i = 0; i < capacity; ++i) {
                 if (other.chunks[i]) {
-                    chunks[i] = new T[CHUNK_SIZE];
+                    chunks[i] = newChunk();
                     for (int j = 0; j < CHUNK_SIZE; ++j)
                         chunks[i][j] = other.chunks[i][j];
                 } else {
@@ -106,41 +130,41 @@ public:
     }
 
     void push_back(const T& value) {
-        int pos = count % CHUNK_SIZE;
-        if (count != 0 && pos == 0)
+        if (backOffset == CHUNK_SIZE) {
             ensureBackSpace();
-        chunks[backIndex][pos] = value;
-        if (pos == CHUNK_SIZE - 1)
-            backIndex++;
+            backOffset = 0;
+        }
+        chunks[backIndex][backOffset++] = value;
         count++;
     }
 
     void push_front(const T& value) {
-        if (count != 0 && count % CHUNK_SIZE == 0)
+        if (frontOffset == 0) {
             ensureFrontSpace();
-        if (count == 0) {
-            chunks[frontIndex][0] = value;
-        } else {
-            if (count % CHUNK_SIZE == 0)
-                frontIndex--;
-            chunks[frontIndex][CHUNK_SIZE - (count % CHUNK_SIZE) - 1] = value;
+            frontOffset = CHUNK_SIZE;
         }
+        chunks[frontIndex][--frontOffset] = value;
         count++;
     }
 
     void pop_back() {
         if (count > 0) {
+            if (backOffset == 0) {
+                --backIndex;
+                backOffset = CHUNK_SIZE;
+            }
+            --backOffset;
             count--;
-            if (count % CHUNK_SIZE == 0)
-                backIndex--;
         }
     }
 
     void pop_front() {
         if (count > 0) {
+            if (++frontOffset == CHUNK_SIZE) {
+                ++frontIndex;
+                frontOffset = 0;
+            }
             count--;
-            if (count % CHUNK_SIZE == 0)
-                frontIndex++;
         }
     }
 
@@ -153,10 +177,12 @@ public:
     }
 
     T& front() {
-        return chunks[frontIndex][0];
+        return chunks[frontIndex][frontOffset];
     }
 
     T& back() {
-        return chunks[backIndex][(count - 1) % CHUNK_SIZE];
+        if (backOffset == 0)
+            return chunks[backIndex - 1][CHUNK_SIZE - 1];
+        return chunks[backIndex][backOffset - 1];
     }
 };
@@ -1,53 +1,109 @@
 #include <iostream> // For basic input/output - std::cout
-#include <memory>   // For smart pointers  - std::unique_ptr
+#include <memory>   // For allocator_traits  - std::allocator
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <utility>  // For std::exchange
+
+#include "container_stats.h" // Opt-in counters (-DCONTAINER_STATS)
 
 // ---------- Matrix class template with fixed size N x M
+// The allocator decides where the N * M doubles live; with a
+// polymorphic_allocator every temporary comes from the same resource.
 
-template <size_t N, size_t M>
+template <size_t N, size_t M, typename Allocator = std::allocator<double>>
 class Matrix {
 private:
-    std::unique_ptr<double[]> data;
+    using Traits = std::allocator_traits<Allocator>;
+
+    [[no_unique_address]] Allocator alloc;
+    double* data = nullptr;
+
+    void allocate() {
+        container_stats::count_allocation<Matrix>(N * M * sizeof(double));
+        data = Traits::allocate(alloc, N * M);
+    }
+
+    void release() {
+        if (data)
+            Traits::deallocate(alloc, data, N * M);
+        data = nullptr;
+    }
 
 public:
+    using allocator_type = Allocator;
+
     // Default constructor
-    Matrix() {
-        data = std::make_unique<double[]>(N * M);
+    Matrix() : Matrix(Allocator()) {}
+
+    explicit Matrix(const Allocator& allocator) : alloc(allocator) {
+        allocate();
         for (size_t i = 0; i < N * M; ++i)
             data[i] = 0;
     }
 
     // Copy constructor
-    Matrix(const Matrix& other) {
-        data = std::make_unique<double[]>(N * M);
+    Matrix(const Matrix& other)
+        : Matrix(other, Traits::select_on_container_copy_construction(other.alloc)) {}
+
+    Matrix(const Matrix& other, const Allocator& allocator) : alloc(allocator) {
+        container_stats::count<Matrix>(container_stats::COPIES);
+        allocate();
         for (size_t i = 0; i < N * M; ++i)
             data[i] = other.data[i];
     }
 
     // Move constructor
-    Matrix(Matrix&& other) {
-        data = std::move(other.data);
+    Matrix(Matrix&& other) noexcept : alloc(other.alloc) {
+        container_stats::count<Matrix>(container_stats::MOVES);
+        data = std::exchange(other.data, nullptr);
     }
 
     // Copy assignment
     Matrix& operator=(const Matrix& other) {
         if (this != &other) {
-            data = std::make_unique<double[]>(N * M);
+            container_stats::count<Matrix>(container_stats::COPIES);
+            if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+                if (alloc != other.alloc) {
+                    release();
+                    alloc = other.alloc;
+                }
+            }
+            if (!data)
+                allocate();
             for (size_t i = 0; i < N * M; ++i)
                 data[i] = other.data[i];
         }
         return *this;
     }
 
-    // Move assignment
-    Matrix& operator=(Matrix&& other) {
+    // Move assignment (steals the buffer only from an equal allocator)
+    Matrix& operator=(Matrix&& other) noexcept(
+        Traits::propagate_on_container_move_assignment::value ||
+        Traits::is_always_equal::value) {
         if (this != &other) {
-            data = std::move(other.data);
+            if constexpr (Traits::propagate_on_container_move_assignment::value) {
+                container_stats::count<Matrix>(container_stats::MOVES);
+                release();
+                alloc = other.alloc;
+                data = std::exchange(other.data, nullptr);
+            } else if (alloc == other.alloc) {
+                container_stats::count<Matrix>(container_stats::MOVES);
+                release();
+                data = std::exchange(other.data, nullptr);
+            } else {
+                *this = static_cast<const Matrix&>(other); // counted as a copy
+            }
         }
         return *this;
     }
 
     // Destructor
-    ~Matrix() {}
+    ~Matrix() {
+        release();
+    }
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
 
     // Element access
     double& at(size_t i, size_t j) {
@@ -60,7 +116,7 @@ public:
 
     // Addition
     Matrix operator+(const Matrix& other) const {
-        Matrix result;
+        Matrix result(alloc);
         for (size_t i = 0; i < N * M; ++i)
             result.data[i] = data[i] + other.data[i];
         return result;
@@ -68,7 +124,7 @@ public:
 
     // Subtraction
     Matrix operator-(const Matrix& other) const {
-        Matrix result;
+        Matrix result(alloc);
         for (size_t i = 0; i < N * M; ++i)
             result.data[i] = data[i] - other.data[i];
         return result;
@@ -76,8 +132,8 @@ public:
 
     // Multiplication (if dimensions match: this[N x M] by other[M x P] = result[N x P])
     template <size_t P>
-    Matrix<N, P> operator*(const Matrix<M, P>& other) const {
-        Matrix<N, P> result;
+    Matrix<N, P, Allocator> operator*(const Matrix<M, P, Allocator>& other) const {
+        Matrix<N, P, Allocator> result(alloc);
         for (size_t i = 0; i < N; ++i) {
             for (size_t j = 0; j < P; ++j) {
                 double sum = 0;
@@ -99,10 +155,13 @@ public:
     }
 };
 
+template <size_t N, size_t M>
+using PmrMatrix = Matrix<N, M, std::pmr::polymorphic_allocator<double>>;
+
 // Transpose function 
-template <typename T, size_t N, size_t M>
-Matrix<M, N> transpose(T&& mat) {
-    Matrix<M, N> result;
+template <size_t N, size_t M, typename Allocator>
+Matrix<M, N, Allocator> transpose(const Matrix<N, M, Allocator>& mat) {
+    Matrix<M, N, Allocator> result(mat.get_allocator());
     for (size_t i = 0; i < N; ++i)
         for (size_t j = 0; j < M; ++j)
             result.at(j, i) = mat.at(i, j);
@@ -137,5 +196,9 @@ int main() {
 
     std::cout << "\nTrace of A: " << trace(A) << "\n";
 
+    // Allocation and copy/move counts, when built with -DCONTAINER_STATS
+    if constexpr (container_stats::enabled)
+        container_stats::print(std::cout, container_stats::snapshot());
+
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -1,133 +1,153 @@
 #include <iostream>
-#include <cstring> // for strlen, strcpy, ...
+#include <bit>     // for std::endian
+#include <cstring> // for strlen, memcpy, ...
+
+#include "container_stats.h" // opt-in counters (-DCONTAINER_STATS)
 
 class MyString {
 private:
-    static const size_t SSO_BUFFER_SIZE = 15; // small string buffer size (fits in the union)
-    
+    // Heap layout; its last byte is shared with the SSO size counter below.
+    struct HeapRep {
+        char* data;
+        size_t size;
+        size_t capacity; // top bit set = string lives on the heap
+    };
+
+    static const size_t SSO_BUFFER_SIZE = sizeof(HeapRep) - 1; // 23 chars, '\0' is the counter itself
+    static const size_t HEAP_FLAG = size_t(1) << (sizeof(size_t) * 8 - 1);
+    static const unsigned char HEAP_TAG = 0x80; // HEAP_FLAG as seen from the last byte
+    static_assert(std::endian::native == std::endian::little, "MyString packs its flag into the top byte of capacity");
+
     union {
-        char ssoBuffer[SSO_BUFFER_SIZE + 1]; 
-        char* heapBuffer;
+        char ssoBuffer[SSO_BUFFER_SIZE + 1]; // last byte = SSO_BUFFER_SIZE - size
+        HeapRep heap;
     };
 
-    size_t _size;
-    size_t _capacity;
-    bool usingSSO;
+    bool usingSSO() const {
+        return (static_cast<unsigned char>(ssoBuffer[SSO_BUFFER_SIZE]) & HEAP_TAG) == 0;
+    }
+
+    void setSSOSize(size_t size) {
+        ssoBuffer[SSO_BUFFER_SIZE] = static_cast<char>(SSO_BUFFER_SIZE - size);
+    }
+
+    char* buffer() {
+        return usingSSO() ? ssoBuffer : heap.data;
+    }
+
+    const char* buffer() const {
+        return usingSSO() ? ssoBuffer : heap.data;
+    }
 
     void allocateHeap(size_t newCapacity) {
+        container_stats::count_allocation<MyString>(newCapacity + 1);
+        container_stats::count<MyString>(container_stats::REGROWTHS);
+        size_t oldSize = size();
         char* newBuffer = new char[newCapacity + 1];
-        if (usingSSO) {
-            std::strcpy(newBuffer, ssoBuffer);
+        std::memcpy(newBuffer, buffer(), oldSize + 1);
+        if (!usingSSO()) {
+            delete[] heap.data;
+        }
+        heap.data = newBuffer;
+        heap.size = oldSize;
+        heap.capacity = newCapacity | HEAP_FLAG;
+    }
+
+    void assign(const char* str, size_t size) {
+        if (size <= SSO_BUFFER_SIZE) {
+            std::memcpy(ssoBuffer, str, size);
+            ssoBuffer[size] = '\0';
+            setSSOSize(size);
         } else {
-            std::strcpy(newBuffer, heapBuffer);
-            delete[] heapBuffer;
+            container_stats::count_allocation<MyString>(size + 1);
+            heap.data = new char[size + 1];
+            std::memcpy(heap.data, str, size + 1);
+            heap.size = size;
+            heap.capacity = size | HEAP_FLAG;
         }
-        heapBuffer = newBuffer;
-        _capacity = newCapacity;
-        usingSSO = false;
     }
 
 public:
     // Default constructor: start as empty string using SSO
-    MyString() : _size(0), _capacity(SSO_BUFFER_SIZE), usingSSO(true) {
+    MyString() {
         ssoBuffer[0] = '\0';
+        setSSOSize(0);
     }
 
     // Constructor from const char*
     MyString(const char* str) {
-        _size = std::strlen(str);
-        if (_size <= SSO_BUFFER_SIZE) {
-            usingSSO = true;
-            _capacity = SSO_BUFFER_SIZE;
-            std::strcpy(ssoBuffer, str);
-        } else {
-            usingSSO = false;
-            _capacity = _size;
-            heapBuffer = new char[_capacity + 1];
-            std::strcpy(heapBuffer, str);
-        }
+        assign(str, std::strlen(str));
     }
 
     // Destructor
     ~MyString() {
-        if (!usingSSO) {
-            delete[] heapBuffer;
+        if (!usingSSO()) {
+            delete[] heap.data;
         }
     }
 
     // Copy constructor
     MyString(const MyString& other) {
-        _size = other._size;
-        _capacity = other._capacity;
-        usingSSO = other.usingSSO;
-        if (usingSSO) {
-            std::strcpy(ssoBuffer, other.ssoBuffer);
+        container_stats::count<MyString>(container_stats::COPIES);
+        if (other.usingSSO()) {
+            std::memcpy(ssoBuffer, other.ssoBuffer, sizeof(ssoBuffer));
         } else {
-            heapBuffer = new char[_capacity + 1];
-            std::strcpy(heapBuffer, other.heapBuffer);
+            assign(other.heap.data, other.heap.size);
         }
     }
 
     // operator[] for getting characters
     char& operator[](size_t index) {
-        if (usingSSO) {
-            return ssoBuffer[index];
-        } else {
-            return heapBuffer[index];
-        }
+        return buffer()[index];
     }
 
     const char& operator[](size_t index) const {
-        if (usingSSO) {
-            return ssoBuffer[index];
-        } else {
-            return heapBuffer[index];
-        }
+        return buffer()[index];
     }
 
     // Add a character at the end
     void add(char c) {
-        if (_size + 1 > _capacity) {
+        size_t oldSize = size();
+        if (oldSize + 1 > capacity()) {
             // Need to allocate more space
-            size_t newCapacity = (_capacity * 2) + 1;
+            size_t newCapacity = (capacity() * 2) + 1;
             allocateHeap(newCapacity);
         }
 
-        if (usingSSO) {
-            ssoBuffer[_size] = c;
-            ssoBuffer[_size + 1] = '\0';
+        char* buf = buffer();
+        buf[oldSize] = c;
+        buf[oldSize + 1] = '\0';
+
+        if (usingSSO()) {
+            setSSOSize(oldSize + 1);
         } else {
-            heapBuffer[_size] = c;
-            heapBuffer[_size + 1] = '\0';
+            heap.size = oldSize + 1;
         }
-
-        _size++;
     }
 
     // Return size
     size_t size() const {
-        return _size;
+        if (usingSSO()) {
+            return SSO_BUFFER_SIZE - static_cast<unsigned char>(ssoBuffer[SSO_BUFFER_SIZE]);
+        }
+        return heap.size;
     }
 
     // Return capacity
     size_t capacity() const {
-        return _capacity;
+        return usingSSO() ? SSO_BUFFER_SIZE : heap.capacity & ~HEAP_FLAG;
     }
 
     // Reserve memory
     void reserve(size_t newCapacity) {
-        if (newCapacity <= _capacity) return;
+        if (newCapacity <= capacity()) return;
 
         allocateHeap(newCapacity);
     }
 
     // Print for debugging
     void print() const {
-        if (usingSSO) {
-            std::cout << ssoBuffer;
-        } else {
-            std::cout << heapBuffer;
-        }
+        std::cout << buffer();
     }
 };
 
@@ -142,5 +162,11 @@ int main() {
     s2.add('?');
     s2.print(); // prints: hello!?
 
+    // Heap allocations and regrowths, when built with -DCONTAINER_STATS
+    if constexpr (container_stats::enabled) {
+        std::cout << "\n";
+        container_stats::print(std::cout, container_stats::snapshot());
+    }
+
     return 0;
 }
@@ -1,101 +1,1233 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "kernel_dispatch.h"
+
+// ---- Integer helpers for Fraction
+
+// |v| as an unsigned value of the same width (exact even for the minimum).
+inline unsigned long long magnitude(long long v) {
+    return v < 0 ? 0ull - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+}
+
+inline unsigned __int128 magnitude(__int128 v) {
+    return v < 0 ? 0 - static_cast<unsigned __int128>(v) : static_cast<unsigned __int128>(v);
+}
+
+inline int trailingZeros(unsigned long long v) {
+    return __builtin_ctzll(v);
+}
+
+inline int trailingZeros(unsigned __int128 v) {
+    unsigned long long low = static_cast<unsigned long long>(v);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<unsigned long long>(v >> 64));
+}
+
+// Stein's binary GCD: shifts and subtractions only, no division. Both
+// values are kept odd and the larger is replaced by |a - b| stripped of its
+// trailing zeros, which compiles to conditional moves rather than branches.
+template <typename U>
+U binaryGcd(U a, U b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int za = trailingZeros(a);
+    int zb = trailingZeros(b);
+    int shift = za < zb ? za : zb;
+    a >>= za;
+    b >>= zb;
+    while (a != b) {
+        U diff = a > b ? a - b : b - a;
+        b = a < b ? a : b;
+        a = diff >> trailingZeros(diff);
+    }
+    return a << shift;
+}
+
+// One Euclid step first: fraction gcds are usually between a large
+// numerator and a small denominator, where subtraction alone needs many
+// rounds to close the size gap.
+inline long long fractionGcd(long long a, long long b) {
+    unsigned long long x = magnitude(a), y = magnitude(b);
+    if (x > y && y != 0) x %= y;
+    else if (y > x && x != 0) y %= x;
+    return static_cast<long long>(binaryGcd(x, y));
+}
+
+// 128-bit values that fit in 64 bits (the common case) take the 64-bit
+// path: the 128-bit shifts and especially divisions are several times slower.
+inline bool fitsIn64(__int128 v) {
+    return v == static_cast<long long>(v);
+}
+
+inline __int128 fractionGcd(__int128 a, __int128 b) {
+    if (fitsIn64(a) && fitsIn64(b)) return fractionGcd(static_cast<long long>(a), static_cast<long long>(b));
+    return static_cast<__int128>(binaryGcd(magnitude(a), magnitude(b)));
+}
+
+inline long long exactDiv(long long a, long long b) {
+    return a / b;
+}
+
+inline __int128 exactDiv(__int128 a, __int128 b) {
+    if (fitsIn64(a) && fitsIn64(b) && a != std::numeric_limits<long long>::min()) {
+        return static_cast<long long>(a) / static_cast<long long>(b);
+    }
+    return a / b;
+}
+
+// ---- Arbitrary-precision integer
+
+// Sign-magnitude integer on 64-bit limbs (least significant first). Values
+// of up to two limbs live inline, so small numbers never allocate.
+// Multiplication is schoolbook below KARATSUBA_THRESHOLD limbs and
+// Karatsuba above it; division is Knuth's algorithm D. / and % truncate
+// toward zero, as for built-in integers.
+class BigInt {
+private:
+    using Limb = unsigned long long;
+    using Wide = unsigned __int128;
+
+    static const size_t INLINE_LIMBS = 2;
+    static const size_t KARATSUBA_THRESHOLD = 32;
+
+    union {
+        Limb small[INLINE_LIMBS] = {};
+        Limb* heap;
+    };
+    unsigned size_ = 0;                 // limbs in use, no leading zero limbs (0 == zero)
+    unsigned capacity_ = INLINE_LIMBS;
+    bool negative = false;              // never set for zero
+
+    Limb* limbs() { return capacity_ > INLINE_LIMBS ? heap : small; }
+    const Limb* limbs() const { return capacity_ > INLINE_LIMBS ? heap : small; }
+
+    // Grow to at least n limbs, keeping the current ones.
+    void reserve(size_t n) {
+        if (n <= capacity_) return;
+        size_t newCapacity = std::max(n, size_t(capacity_) * 2);
+        Limb* buffer = new Limb[newCapacity];
+        std::copy(limbs(), limbs() + size_, buffer);
+        if (capacity_ > INLINE_LIMBS) delete[] heap;
+        heap = buffer;
+        capacity_ = static_cast<unsigned>(newCapacity);
+    }
+
+    // Set the limb count to n (after writing them) and drop leading zeros.
+    void setSize(size_t n) {
+        const Limb* d = limbs();
+        while (n > 0 && d[n - 1] == 0) --n;
+        size_ = static_cast<unsigned>(n);
+        if (size_ == 0) negative = false;
+    }
+
+    void assignMagnitude(const Limb* d, size_t n) {
+        reserve(n);
+        std::copy(d, d + n, limbs());
+        setSize(n);
+    }
+
+    // ---- magnitude kernels on raw limb arrays
+
+    static int compareMagnitude(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        if (na != nb) return na < nb ? -1 : 1;
+        for (size_t i = na; i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // out = a + b with na >= nb; out may alias a or b and needs na + 1 limbs.
+    // Returns the limb count written.
+    static size_t addMagnitude(Limb* out, const Limb* a, size_t na, const Limb* b, size_t nb) {
+        Limb carry = 0;
+        size_t i = 0;
+        for (; i < nb; ++i) {
+            Wide sum = Wide(a[i]) + b[i] + carry;
+            out[i] = static_cast<Limb>(sum);
+            carry = static_cast<Limb>(sum >> 64);
+        }
+        for (; i < na; ++i) {
+            Limb sum = a[i] + carry;
+            carry = sum < carry;
+            out[i] = sum;
+        }
+        out[na] = carry;
+        return na + 1;
+    }
+
+    // out = a - b with a >= b; out may alias a or b and needs na limbs.
+    static void subMagnitude(Limb* out, const Limb* a, size_t na, const Limb* b, size_t nb) {
+        Limb borrow = 0;
+        for (size_t i = 0; i < na; ++i) {
+            Limb x = a[i];
+            Limb y = i < nb ? b[i] : 0;
+            Limb diff = x - y;
+            Limb borrowOut = x < y;
+            out[i] = diff - borrow;
+            borrow = borrowOut | (diff < borrow);
+        }
+    }
+
+    // out[0, n) += src, carrying upward; the true sum must fit in n limbs.
+    static void addInto(Limb* out, size_t n, const Limb* src, size_t ns) {
+        while (ns > 0 && src[ns - 1] == 0) --ns;
+        Limb carry = 0;
+        size_t i = 0;
+        for (; i < ns; ++i) {
+            Wide sum = Wide(out[i]) + src[i] + carry;
+            out[i] = static_cast<Limb>(sum);
+            carry = static_cast<Limb>(sum >> 64);
+        }
+        for (; carry && i < n; ++i) {
+            out[i] += carry;
+            carry = out[i] == 0;
+        }
+    }
+
+    static void mulSchoolbook(Limb* out, const Limb* a, size_t na, const Limb* b, size_t nb) {
+        std::fill(out, out + na + nb, Limb(0));
+        for (size_t i = 0; i < na; ++i) {
+            Limb carry = 0;
+            for (size_t j = 0; j < nb; ++j) {
+                Wide t = Wide(a[i]) * b[j] + out[i + j] + carry;
+                out[i + j] = static_cast<Limb>(t);
+                carry = static_cast<Limb>(t >> 64);
+            }
+            out[i + nb] = carry;
+        }
+    }
+
+    // out (na + nb limbs, fully written) = a * b.
+    static void mulMagnitude(Limb* out, const Limb* a, size_t na, const Limb* b, size_t nb) {
+        if (na < nb) {
+            std::swap(a, b);
+            std::swap(na, nb);
+        }
+        if (nb < KARATSUBA_THRESHOLD) {
+            mulSchoolbook(out, a, na, b, nb);
+            return;
+        }
+        std::fill(out, out + na + nb, Limb(0));
+        if (na >= 2 * nb) {
+            // Unbalanced: multiply b by nb-limb slices of a.
+            std::vector<Limb> part(2 * nb);
+            for (size_t offset = 0; offset < na; offset += nb) {
+                size_t len = std::min(nb, na - offset);
+                mulMagnitude(part.data(), a + offset, len, b, nb);
+                addInto(out + offset, na + nb - offset, part.data(), len + nb);
+            }
+            return;
+        }
+
+        // a = a1 * B^m + a0, b = b1 * B^m + b0 (nb > m >= na - m)
+        size_t m = (na + 1) / 2;
+        size_t na1 = na - m, nb1 = nb - m;
+        std::vector<Limb> z0(2 * m), z2(na1 + nb1), z1(2 * m + 2);
+        std::vector<Limb> sa(m + 1), sb(m + 1);
+        mulMagnitude(z0.data(), a, m, b, m);
+        mulMagnitude(z2.data(), a + m, na1, b + m, nb1);
+        addMagnitude(sa.data(), a, m, a + m, na1);
+        addMagnitude(sb.data(), b, m, b + m, nb1);
+        mulMagnitude(z1.data(), sa.data(), m + 1, sb.data(), m + 1);
+        subMagnitude(z1.data(), z1.data(), z1.size(), z0.data(), z0.size());
+        subMagnitude(z1.data(), z1.data(), z1.size(), z2.data(), z2.size());
+
+        addInto(out, na + nb, z0.data(), z0.size());
+        addInto(out + m, na + nb - m, z1.data(), z1.size());
+        addInto(out + 2 * m, na + nb - 2 * m, z2.data(), z2.size());
+    }
+
+    // a[0, n) /= d in place; returns the remainder. Uses a precomputed
+    // reciprocal of the normalized divisor (Moller & Granlund, "Improved
+    // division by invariant integers", 2011), so each limb costs two
+    // multiplications instead of a hardware 128/64 division.
+    static Limb divSmall(Limb* a, size_t n, Limb d) {
+        if (n == 0) return 0;
+        int s = __builtin_clzll(d);
+        Limb dn = d << s;
+        Limb v = static_cast<Limb>(((Wide(~dn) << 64) | ~Limb(0)) / dn);
+
+        Limb rem = s ? a[n - 1] >> (64 - s) : 0; // < dn, as the algorithm needs
+        for (size_t i = n; i-- > 0;) {
+            Limb u0 = s ? (a[i] << s) | (i ? a[i - 1] >> (64 - s) : 0) : a[i];
+            Wide qq = Wide(v) * rem + ((Wide(rem + 1) << 64) | u0);
+            Limb q1 = static_cast<Limb>(qq >> 64);
+            Limb q0 = static_cast<Limb>(qq);
+            Limb r = u0 - q1 * dn;
+            if (r > q0) {
+                --q1;
+                r += dn;
+            }
+            if (r >= dn) {
+                ++q1;
+                r -= dn;
+            }
+            a[i] = q1;
+            rem = r;
+        }
+        return rem >> s;
+    }
+
+    // Knuth, TAOCP 4.3.1 algorithm D: q = a / b, r = a % b for na >= nb >= 2.
+    static void divKnuth(const Limb* a, size_t na, const Limb* b, size_t nb, BigInt& q, BigInt& r) {
+        int s = __builtin_clzll(b[nb - 1]);
+        auto shifted = [s](const Limb* x, size_t i) {
+            return s ? (x[i] << s) | (i ? x[i - 1] >> (64 - s) : 0) : x[i];
+        };
+        std::vector<Limb> v(nb), u(na + 1);
+        for (size_t i = 0; i < nb; ++i) v[i] = shifted(b, i);
+        for (size_t i = 0; i < na; ++i) u[i] = shifted(a, i);
+        u[na] = s ? a[na - 1] >> (64 - s) : 0;
+
+        q.reserve(na - nb + 1);
+        Limb* qd = q.limbs();
+        for (size_t j = na - nb + 1; j-- > 0;) {
+            Wide num = (Wide(u[j + nb]) << 64) | u[j + nb - 1];
+            Wide qhat = num / v[nb - 1];
+            Wide rhat = num % v[nb - 1];
+            while ((qhat >> 64) || qhat * v[nb - 2] > ((rhat << 64) | u[j + nb - 2])) {
+                --qhat;
+                rhat += v[nb - 1];
+                if (rhat >> 64) break;
+            }
+
+            // u[j, j + nb] -= qhat * v
+            Limb carry = 0, borrow = 0;
+            for (size_t i = 0; i < nb; ++i) {
+                Wide p = qhat * v[i] + carry;
+                carry = static_cast<Limb>(p >> 64);
+                Limb low = static_cast<Limb>(p);
+                Limb diff = u[i + j] - low;
+                Limb borrowOut = u[i + j] < low;
+                u[i + j] = diff - borrow;
+                borrow = borrowOut | (diff < borrow);
+            }
+            Limb top = u[j + nb];
+            Limb diff = top - carry;
+            bool negativeResult = top < carry || diff < borrow;
+            u[j + nb] = diff - borrow;
+
+            if (negativeResult) {
+                // qhat was one too large: add v back.
+                --qhat;
+                Limb c = 0;
+                for (size_t i = 0; i < nb; ++i) {
+                    Wide sum = Wide(u[i + j]) + v[i] + c;
+                    u[i + j] = static_cast<Limb>(sum);
+                    c = static_cast<Limb>(sum >> 64);
+                }
+                u[j + nb] += c;
+            }
+            qd[j] = static_cast<Limb>(qhat);
+        }
+        q.setSize(na - nb + 1);
+
+        r.reserve(nb);
+        Limb* rd = r.limbs();
+        for (size_t i = 0; i < nb; ++i) {
+            rd[i] = s ? (u[i] >> s) | (u[i + 1] << (64 - s)) : u[i];
+        }
+        r.setSize(nb);
+    }
+
+    // this += other, with other's sign taken as otherNegative (so -= can
+    // reuse it without copying other).
+    void addSigned(const BigInt& other, bool otherNegative) {
+        if (&other == this) {
+            BigInt copy(other);
+            addSigned(copy, otherNegative);
+            return;
+        }
+        size_t na = size_, nb = other.size_;
+        if (negative == otherNegative) {
+            reserve(std::max(na, nb) + 1);
+            if (na >= nb) {
+                setSize(addMagnitude(limbs(), limbs(), na, other.limbs(), nb));
+            } else {
+                setSize(addMagnitude(limbs(), other.limbs(), nb, limbs(), na));
+            }
+            return;
+        }
+        int cmp = compareMagnitude(limbs(), na, other.limbs(), nb);
+        if (cmp >= 0) {
+            subMagnitude(limbs(), limbs(), na, other.limbs(), nb);
+            setSize(na);
+        } else {
+            reserve(nb);
+            subMagnitude(limbs(), other.limbs(), nb, limbs(), na);
+            negative = otherNegative;
+            setSize(nb);
+        }
+    }
+
+public:
+    BigInt() {}
+
+    BigInt(long long value) : negative(value < 0) {
+        unsigned long long mag = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+        small[0] = mag;
+        size_ = mag != 0;
+    }
+
+    static BigInt fromMagnitude(unsigned long long value) {
+        BigInt result;
+        result.small[0] = value;
+        result.size_ = value != 0;
+        return result;
+    }
+
+    explicit BigInt(const std::string& text) {
+        size_t i = 0;
+        bool minus = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) minus = text[i++] == '-';
+        if (i == text.size()) throw std::invalid_argument("BigInt: no digits.");
+        for (; i < text.size(); ++i) {
+            if (text[i] < '0' || text[i] > '9') throw std::invalid_argument("BigInt: bad digit.");
+            mulAddSmall(10, static_cast<Limb>(text[i] - '0'));
+        }
+        negative = minus && size_ != 0;
+    }
+
+    BigInt(const BigInt& other) : negative(other.negative) {
+        assignMagnitude(other.limbs(), other.size_);
+    }
+
+    BigInt(BigInt&& other) noexcept : size_(other.size_), capacity_(other.capacity_), negative(other.negative) {
+        if (capacity_ > INLINE_LIMBS) {
+            heap = other.heap;
+        } else {
+            std::copy(other.small, other.small + INLINE_LIMBS, small);
+        }
+        other.size_ = 0;
+        other.capacity_ = INLINE_LIMBS;
+        other.negative = false;
+    }
+
+    BigInt& operator=(const BigInt& other) {
+        if (this != &other) {
+            assignMagnitude(other.limbs(), other.size_);
+            negative = other.negative;
+        }
+        return *this;
+    }
+
+    BigInt& operator=(BigInt&& other) noexcept {
+        if (this != &other) {
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~BigInt() {
+        if (capacity_ > INLINE_LIMBS) delete[] heap;
+    }
+
+    void swap(BigInt& other) noexcept {
+        std::swap(small, other.small); // also swaps heap, which shares the storage
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(negative, other.negative);
+    }
+
+    bool isZero() const { return size_ == 0; }
+    bool isNegative() const { return negative; }
+    size_t limbCount() const { return size_; }
+    bool fitsInLimb() const { return size_ <= 1; }
+    unsigned long long lowLimb() const { return size_ ? limbs()[0] : 0; }
+
+    // this = this * m + add, on the magnitude.
+    void mulAddSmall(unsigned long long m, unsigned long long add) {
+        reserve(size_ + 1);
+        Limb* d = limbs();
+        Limb carry = add;
+        for (size_t i = 0; i < size_; ++i) {
+            Wide t = Wide(d[i]) * m + carry;
+            d[i] = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> 64);
+        }
+        d[size_] = carry;
+        setSize(size_ + 1);
+    }
+
+    BigInt abs() const {
+        BigInt result(*this);
+        result.negative = false;
+        return result;
+    }
+
+    BigInt operator-() const {
+        BigInt result(*this);
+        result.negative = !negative && size_ != 0;
+        return result;
+    }
+
+    BigInt& operator+=(const BigInt& other) {
+        addSigned(other, other.negative);
+        return *this;
+    }
+
+    BigInt& operator-=(const BigInt& other) {
+        addSigned(other, !other.negative && other.size_ != 0);
+        return *this;
+    }
+
+    BigInt& operator*=(const BigInt& other) {
+        *this = *this * other;
+        return *this;
+    }
+
+    BigInt& operator/=(const BigInt& other) {
+        BigInt q, r;
+        divmod(*this, other, q, r);
+        swap(q);
+        return *this;
+    }
+
+    BigInt& operator%=(const BigInt& other) {
+        BigInt q, r;
+        divmod(*this, other, q, r);
+        swap(r);
+        return *this;
+    }
+
+    friend BigInt operator+(BigInt a, const BigInt& b) { return a += b; }
+    friend BigInt operator-(BigInt a, const BigInt& b) { return a -= b; }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        BigInt result;
+        if (a.isZero() || b.isZero()) return result;
+        result.reserve(a.size_ + b.size_);
+        mulMagnitude(result.limbs(), a.limbs(), a.size_, b.limbs(), b.size_);
+        result.setSize(a.size_ + b.size_);
+        result.negative = a.negative != b.negative;
+        return result;
+    }
+
+    friend BigInt operator/(const BigInt& a, const BigInt& b) {
+        BigInt q, r;
+        divmod(a, b, q, r);
+        return q;
+    }
+
+    friend BigInt operator%(const BigInt& a, const BigInt& b) {
+        BigInt q, r;
+        divmod(a, b, q, r);
+        return r;
+    }
+
+    // q = a / b truncated toward zero, r = a - q * b (sign of a).
+    static void divmod(const BigInt& a, const BigInt& b, BigInt& q, BigInt& r) {
+        if (b.isZero()) throw std::domain_error("BigInt division by zero.");
+        if (compareMagnitude(a.limbs(), a.size_, b.limbs(), b.size_) < 0) {
+            q = BigInt();
+            r = a;
+            return;
+        }
+        if (b.size_ == 1) {
+            q = a;
+            Limb rem = divSmall(q.limbs(), q.size_, b.limbs()[0]);
+            q.setSize(q.size_);
+            r = fromMagnitude(rem);
+        } else {
+            divKnuth(a.limbs(), a.size_, b.limbs(), b.size_, q, r);
+        }
+        q.negative = a.negative != b.negative && q.size_ != 0;
+        r.negative = a.negative && r.size_ != 0;
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) {
+        return a.negative == b.negative && compareMagnitude(a.limbs(), a.size_, b.limbs(), b.size_) == 0;
+    }
+
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return !(a == b); }
+
+    friend bool operator<(const BigInt& a, const BigInt& b) {
+        if (a.negative != b.negative) return a.negative;
+        int cmp = compareMagnitude(a.limbs(), a.size_, b.limbs(), b.size_);
+        return a.negative ? cmp > 0 : cmp < 0;
+    }
+
+    friend bool operator>(const BigInt& a, const BigInt& b) { return b < a; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) { return !(b < a); }
+    friend bool operator>=(const BigInt& a, const BigInt& b) { return !(a < b); }
+
+    // The top two limbs (at least 64 significant bits) as a double, with
+    // *this == result * 2^exponent up to rounding; finite for any size.
+    double scaled(long& exponent) const {
+        exponent = size_ > 1 ? 64 * static_cast<long>(size_ - 2) : 0;
+        if (size_ == 0) return 0.0;
+        const Limb* d = limbs();
+        double top = static_cast<double>(d[size_ - 1]);
+        if (size_ > 1) top = top * 18446744073709551616.0 + static_cast<double>(d[size_ - 2]);
+        return negative ? -top : top;
+    }
+
+    explicit operator double() const {
+        long exponent;
+        double top = scaled(exponent);
+        return std::ldexp(top, static_cast<int>(std::min<long>(exponent, std::numeric_limits<int>::max())));
+    }
+
+    std::string toString() const {
+        if (size_ == 0) return "0";
+        const Limb chunk = 10000000000000000000ull; // 10^19
+        std::vector<Limb> work(limbs(), limbs() + size_);
+        std::string digits;
+        size_t n = work.size();
+        while (n > 0) {
+            Limb rem = divSmall(work.data(), n, chunk);
+            while (n > 0 && work[n - 1] == 0) --n;
+            for (int i = 0; i < 19 && (n > 0 || rem != 0); ++i) {
+                digits += static_cast<char>('0' + rem % 10);
+                rem /= 10;
+            }
+        }
+        if (negative) digits += '-';
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BigInt& value) {
+        return os << value.toString();
+    }
+
+    // Reads an optional sign and decimal digits, stopping at anything else
+    // (so "3/4" reads as 3, then '/', then 4).
+    friend std::istream& operator>>(std::istream& is, BigInt& value) {
+        std::string text;
+        is >> std::ws;
+        if (is.peek() == '-' || is.peek() == '+') text += static_cast<char>(is.get());
+        while (std::isdigit(is.peek())) text += static_cast<char>(is.get());
+        if (text.empty() || text == "-" || text == "+") {
+            is.setstate(std::ios::failbit);
+        } else {
+            value = BigInt(text);
+        }
+        return is;
+    }
+};
+
+inline BigInt fractionGcd(BigInt a, BigInt b) {
+    a = a.abs();
+    b = b.abs();
+    // Euclid while the operands are big (one step takes a huge numerator
+    // down to the size of a small denominator), binary GCD once both fit a limb.
+    while (!b.isZero()) {
+        if (a.fitsInLimb() && b.fitsInLimb()) {
+            return BigInt::fromMagnitude(binaryGcd(a.lowLimb(), b.lowLimb()));
+        }
+        a %= b;
+        a.swap(b);
+    }
+    return a;
+}
+
+inline BigInt exactDiv(const BigInt& a, const BigInt& b) {
+    if (b == 1) return a;
+    return a / b;
+}
+
+// Wide: an integer type in which a*d + c*b cannot overflow for any
+// numerators/denominators a, b, c, d of type Int.
+// narrow: checked conversion of a reduced result back to Int.
+template <typename Int>
+struct FractionTraits {
+    static_assert(std::is_integral<Int>::value && std::is_signed<Int>::value && sizeof(Int) <= 8,
+                  "Fraction<Int> needs a signed integer of at most 64 bits");
+
+    using Wide = std::conditional_t<(sizeof(Int) <= 4), long long, __int128>;
+
+    static Int narrow(Wide v) {
+        if (v < static_cast<Wide>(std::numeric_limits<Int>::min()) ||
+            v > static_cast<Wide>(std::numeric_limits<Int>::max())) {
+            throw std::overflow_error("Fraction overflow.");
+        }
+        return static_cast<Int>(v);
+    }
+};
+
+// BigInt cannot overflow: it is its own wide type.
+template <>
+struct FractionTraits<BigInt> {
+    using Wide = BigInt;
+
+    static BigInt narrow(BigInt v) { return v; }
+};
+
+template <typename Int = int>
 class Fraction {
 private:
-    int numerator, denominator;
+    using Traits = FractionTraits<Int>;
+    using Wide = typename Traits::Wide;
+
+    Int numerator, denominator; // always reduced, denominator > 0
 
-    int gcd(int a, int b) const {
-        return b == 0 ? a : gcd(b, a % b);
+    // Store num/den, which is already in lowest terms (den != 0).
+    void assignReduced(Wide num, Wide den) {
+        if (num == 0) {
+            den = 1;
+        } else if (den < 0) {
+            num = -num;
+            den = -den;
+        }
+        numerator = Traits::narrow(num);
+        denominator = Traits::narrow(den);
     }
 
-    void simplify() {
-        int g = gcd(numerator, denominator);
-        numerator /= g;
-        denominator /= g;
-        if (denominator < 0) {
-            numerator = -numerator;
-            denominator = -denominator;
+    void assign(Wide num, Wide den) {
+        Wide g = fractionGcd(num, den);
+        assignReduced(exactDiv(num, g), exactDiv(den, g));
+    }
+
+    // this += c/d. Reduces by gcd(b, d) before multiplying, so intermediates
+    // are no larger than the result needs (Knuth, TAOCP 4.5.1).
+    void addReduced(Wide c, Wide d) {
+        Wide a = numerator, b = denominator;
+        Wide g = fractionGcd(b, d);
+        if (g == 1) {
+            assignReduced(a * d + c * b, b * d);
+            return;
         }
+        Wide bg = exactDiv(b, g);
+        Wide t = a * exactDiv(d, g) + c * bg;
+        Wide g2 = fractionGcd(t, g);
+        assignReduced(exactDiv(t, g2), bg * exactDiv(d, g2));
+    }
+
+    // this *= c/d, cross-reducing a with d and c with b first.
+    void mulReduced(Wide c, Wide d) {
+        Wide a = numerator, b = denominator;
+        Wide g1 = fractionGcd(a, d);
+        Wide g2 = fractionGcd(c, b);
+        assignReduced(exactDiv(a, g1) * exactDiv(c, g2), exactDiv(b, g2) * exactDiv(d, g1));
     }
 
 public:
     // Constructors
-    Fraction(int num = 0, int den = 1) : numerator(num), denominator(den) {
+    Fraction(Int num = 0, Int den = 1) {
         if (den == 0) throw std::invalid_argument("Denominator cannot be zero.");
-        simplify();
+        assign(num, den);
     }
 
     Fraction(const Fraction& other) = default; // Copy Constructor
     Fraction& operator=(const Fraction& other) = default; // Assignment Operator
 
     // Getters and Setters
-    int getNumerator() const { return numerator; }
-    int getDenominator() const { return denominator; }
-    void setNumerator(int num) { numerator = num; simplify(); }
-    void setDenominator(int den) {
+    Int getNumerator() const { return numerator; }
+    Int getDenominator() const { return denominator; }
+    void setNumerator(Int num) { assign(num, denominator); }
+    void setDenominator(Int den) {
         if (den == 0) throw std::invalid_argument("Denominator cannot be zero.");
-        denominator = den; simplify();
+        assign(numerator, den);
     }
 
     // Conversion to double
     double toDouble() const {
-        return static_cast<double>(numerator) / denominator;
+        if constexpr (std::is_same_v<Int, BigInt>) {
+            // Either side may be beyond double's range (inf / inf = NaN), so
+            // divide their top bits and apply the exponents afterwards.
+            long numExp, denExp;
+            double ratio = numerator.scaled(numExp) / denominator.scaled(denExp);
+            long exponent = std::clamp<long>(numExp - denExp, std::numeric_limits<int>::min(),
+                                             std::numeric_limits<int>::max());
+            return std::ldexp(ratio, static_cast<int>(exponent));
+        } else {
+            return static_cast<double>(numerator) / static_cast<double>(denominator);
+        }
     }
 
-    // Arithmetic operators
-    Fraction operator+(const Fraction& other) const {
-        return Fraction(numerator * other.denominator + other.numerator * denominator, denominator * other.denominator);
+    // Compound assignment operators (in place; throw std::overflow_error if
+    // the reduced result does not fit in Int)
+    Fraction& operator+=(const Fraction& other) {
+        addReduced(other.numerator, other.denominator);
+        return *this;
     }
 
-    Fraction operator-(const Fraction& other) const {
-        return Fraction(numerator * other.denominator - other.numerator * denominator, denominator * other.denominator);
+    Fraction& operator-=(const Fraction& other) {
+        addReduced(-static_cast<Wide>(other.numerator), other.denominator);
+        return *this;
     }
 
-    Fraction operator*(const Fraction& other) const {
-        return Fraction(numerator * other.numerator, denominator * other.denominator);
+    Fraction& operator*=(const Fraction& other) {
+        mulReduced(other.numerator, other.denominator);
+        return *this;
     }
 
-    Fraction operator/(const Fraction& other) const {
+    Fraction& operator/=(const Fraction& other) {
         if (other.numerator == 0) throw std::invalid_argument("Cannot divide by zero fraction.");
-        return Fraction(numerator * other.denominator, denominator * other.numerator);
+        mulReduced(other.denominator, other.numerator);
+        return *this;
     }
 
-    // Compound assignment operators
-    Fraction& operator+=(const Fraction& other) {
-        *this = *this + other;
-        return *this;
+    // Arithmetic operators
+    Fraction operator+(const Fraction& other) const {
+        Fraction result(*this);
+        return result += other;
     }
 
-    Fraction& operator-=(const Fraction& other) {
-        *this = *this - other;
-        return *this;
+    Fraction operator-(const Fraction& other) const {
+        Fraction result(*this);
+        return result -= other;
     }
 
-    Fraction& operator*=(const Fraction& other) {
-        *this = *this * other;
-        return *this;
+    Fraction operator*(const Fraction& other) const {
+        Fraction result(*this);
+        return result *= other;
     }
 
-    Fraction& operator/=(const Fraction& other) {
-        *this = *this / other;
-        return *this;
+    Fraction operator/(const Fraction& other) const {
+        Fraction result(*this);
+        return result /= other;
     }
 
     // Overload << and >> operators
     friend std::ostream& operator<<(std::ostream& os, const Fraction& f) {
-        os << f.numerator << (f.denominator != 1 ? "/" + std::to_string(f.denominator) : "");
+        os << f.numerator;
+        if (f.denominator != 1) os << '/' << f.denominator;
         return os;
     }
 
     friend std::istream& operator>>(std::istream& is, Fraction& f) {
+        Int num, den;
         char slash;
-        is >> f.numerator >> slash >> f.denominator;
-        if (slash != '/' || f.denominator == 0) is.setstate(std::ios::failbit);
-        else f.simplify();
+        is >> num >> slash >> den;
+        if (slash != '/' || den == 0) is.setstate(std::ios::failbit);
+        else f.assign(num, den);
         return is;
     }
 };
 
+// ---- Column kernels behind FractionArray
+//
+// Columns are stored as separate numerator and denominator arrays with
+// positive but not necessarily reduced denominators, so add/mul/compare
+// are plain multiply-adds with no gcd. Each kernel works through the
+// column in order and stops at the first element whose result does not fit
+// in Int, returning its index; FractionArray reduces that one element
+// exactly and resumes after it. Fraction<int> columns have AVX2 versions
+// (8 lanes, products in 64 bits); kernels<Int>() picks once per process.
+namespace fractionKernels {
+
+template <typename Int>
+using Wide = typename FractionTraits<Int>::Wide;
+
+template <typename Int>
+struct Kernels {
+    size_t (*add)(Int* a, Int* b, const Int* c, const Int* d, size_t n); // a/b += c/d
+    size_t (*mul)(Int* a, Int* b, const Int* c, const Int* d, size_t n); // a/b *= c/d
+    void (*compare)(const Int* a, const Int* b, const Int* c, const Int* d, signed char* out, size_t n);
+};
+
+template <typename Int>
+inline bool fitsInt(Wide<Int> v) {
+    return v >= static_cast<Wide<Int>>(std::numeric_limits<Int>::min()) &&
+           v <= static_cast<Wide<Int>>(std::numeric_limits<Int>::max());
+}
+
+// a/b + c/d unreduced; equal denominators (the common case for columns of
+// prices, shares, ...) just add numerators, so they do not grow.
+template <typename Int>
+inline void addTerms(Int a, Int b, Int c, Int d, Wide<Int>& num, Wide<Int>& den) {
+    if (b == d) {
+        num = static_cast<Wide<Int>>(a) + c;
+        den = b;
+    } else {
+        num = static_cast<Wide<Int>>(a) * d + static_cast<Wide<Int>>(c) * b;
+        den = static_cast<Wide<Int>>(b) * d;
+    }
+}
+
+template <typename Int>
+size_t addPortable(Int* a, Int* b, const Int* c, const Int* d, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Wide<Int> num, den;
+        addTerms(a[i], b[i], c[i], d[i], num, den);
+        if (!fitsInt<Int>(num) || !fitsInt<Int>(den)) return i;
+        a[i] = static_cast<Int>(num);
+        b[i] = static_cast<Int>(den);
+    }
+    return n;
+}
+
+template <typename Int>
+size_t mulPortable(Int* a, Int* b, const Int* c, const Int* d, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Wide<Int> num = static_cast<Wide<Int>>(a[i]) * c[i];
+        Wide<Int> den = static_cast<Wide<Int>>(b[i]) * d[i];
+        if (!fitsInt<Int>(num) || !fitsInt<Int>(den)) return i;
+        a[i] = static_cast<Int>(num);
+        b[i] = static_cast<Int>(den);
+    }
+    return n;
+}
+
+// out[i] = sign(a/b - c/d) = sign(a*d - c*b), denominators being positive.
+template <typename Int>
+void comparePortable(const Int* a, const Int* b, const Int* c, const Int* d, signed char* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Wide<Int> lhs = static_cast<Wide<Int>>(a[i]) * d[i];
+        Wide<Int> rhs = static_cast<Wide<Int>>(c[i]) * b[i];
+        out[i] = static_cast<signed char>((lhs > rhs) - (lhs < rhs));
+    }
+}
+
+#ifdef KERNEL_DISPATCH_X86
+
+// The AVX2 kernels work on the even and odd int32 lanes separately: each
+// 64-bit lane holds one value in its low half, _mm256_mul_epi32 gives the
+// exact 64-bit product, and multiplying by 1 sign-extends.
+
+__attribute__((target("avx2"))) inline __m256i oddLanes(__m256i v) {
+    return _mm256_srli_epi64(v, 32);
+}
+
+__attribute__((target("avx2"))) inline __m256i widen(__m256i v) {
+    return _mm256_mul_epi32(v, _mm256_set1_epi64x(1));
+}
+
+// All-ones in each 64-bit lane that fits in int32.
+__attribute__((target("avx2"))) inline __m256i fitsInt32(__m256i v) {
+    return _mm256_cmpeq_epi64(v, widen(v));
+}
+
+// Low halves of the 64-bit lanes of even and odd back into 8 int32 lanes.
+__attribute__((target("avx2"))) inline __m256i interleave(__m256i even, __m256i odd) {
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+__attribute__((target("avx2"))) inline void addHalf(__m256i a, __m256i b, __m256i c, __m256i d,
+                                                    __m256i& num, __m256i& den) {
+    __m256i same = _mm256_cmpeq_epi64(widen(b), widen(d));
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epi32(a, d), _mm256_mul_epi32(c, b));
+    num = _mm256_blendv_epi8(cross, _mm256_add_epi64(widen(a), widen(c)), same);
+    den = _mm256_blendv_epi8(_mm256_mul_epi32(b, d), widen(b), same);
+}
+
+__attribute__((target("avx2"))) inline size_t addAvx2(int* a, int* b, const int* c, const int* d, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        __m256i numEven, denEven, numOdd, denOdd;
+        addHalf(va, vb, vc, vd, numEven, denEven);
+        addHalf(oddLanes(va), oddLanes(vb), oddLanes(vc), oddLanes(vd), numOdd, denOdd);
+        __m256i fits = _mm256_and_si256(_mm256_and_si256(fitsInt32(numEven), fitsInt32(denEven)),
+                                        _mm256_and_si256(fitsInt32(numOdd), fitsInt32(denOdd)));
+        if (_mm256_movemask_epi8(fits) != -1) break; // the portable loop finds the lane
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), interleave(numEven, numOdd));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), interleave(denEven, denOdd));
+    }
+    return i + addPortable<int>(a + i, b + i, c + i, d + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t mulAvx2(int* a, int* b, const int* c, const int* d, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        __m256i numEven = _mm256_mul_epi32(va, vc);
+        __m256i denEven = _mm256_mul_epi32(vb, vd);
+        __m256i numOdd = _mm256_mul_epi32(oddLanes(va), oddLanes(vc));
+        __m256i denOdd = _mm256_mul_epi32(oddLanes(vb), oddLanes(vd));
+        __m256i fits = _mm256_and_si256(_mm256_and_si256(fitsInt32(numEven), fitsInt32(denEven)),
+                                        _mm256_and_si256(fitsInt32(numOdd), fitsInt32(denOdd)));
+        if (_mm256_movemask_epi8(fits) != -1) break;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), interleave(numEven, numOdd));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), interleave(denEven, denOdd));
+    }
+    return i + mulPortable<int>(a + i, b + i, c + i, d + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline void compareAvx2(const int* a, const int* b, const int* c, const int* d,
+                                                        signed char* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        __m256i lhsEven = _mm256_mul_epi32(va, vd), rhsEven = _mm256_mul_epi32(vc, vb);
+        __m256i lhsOdd = _mm256_mul_epi32(oddLanes(va), oddLanes(vd));
+        __m256i rhsOdd = _mm256_mul_epi32(oddLanes(vc), oddLanes(vb));
+        // (lhs < rhs ? -1 : 0) - (lhs > rhs ? -1 : 0)
+        __m256i even = _mm256_sub_epi64(_mm256_cmpgt_epi64(rhsEven, lhsEven), _mm256_cmpgt_epi64(lhsEven, rhsEven));
+        __m256i odd = _mm256_sub_epi64(_mm256_cmpgt_epi64(rhsOdd, lhsOdd), _mm256_cmpgt_epi64(lhsOdd, rhsOdd));
+        __m256i signs = interleave(even, odd);
+        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(signs), _mm256_extracti128_si256(signs, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi16(words, words));
+    }
+    comparePortable<int>(a + i, b + i, c + i, d + i, out + i, n - i);
+}
+
+#endif // KERNEL_DISPATCH_X86
+
+using kernel_dispatch::Level;
+
+template <typename Int>
+Kernels<Int> kernelsFor(Level level) {
+#ifdef KERNEL_DISPATCH_X86
+    if constexpr (std::is_same_v<Int, int>) {
+        return kernel_dispatch::select<Kernels<int>>(level, {
+            {Level::AVX2, kernel_dispatch::AVX2, {addAvx2, mulAvx2, compareAvx2}},
+            {Level::Portable, kernel_dispatch::NONE, {addPortable<int>, mulPortable<int>, comparePortable<int>}},
+        });
+    }
+#endif
+    (void)level;
+    return {addPortable<Int>, mulPortable<Int>, comparePortable<Int>};
+}
+
+template <typename Int>
+const Kernels<Int>& kernels() { return kernel_dispatch::best<Kernels<Int>, kernelsFor<Int>>(); }
+
+// Below these many elements one thread is faster: the streaming kernels
+// cost about a nanosecond per element, a gcd some tens of nanoseconds.
+const size_t STREAM_PARALLEL_THRESHOLD = 1 << 20;
+const size_t GCD_PARALLEL_THRESHOLD = 1 << 14;
+
+inline size_t maxChunks() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls body(chunk, begin, end) for one contiguous chunk per worker (a
+// single chunk below `threshold`) and returns the number of chunks. An
+// exception from any chunk is rethrown once all of them have finished.
+template <typename Body>
+size_t parallelFor(size_t n, size_t threshold, Body&& body) {
+    size_t workers = n < threshold ? 1 : maxChunks();
+    if (workers == 1) {
+        body(size_t(0), size_t(0), n);
+        return 1;
+    }
+    // Chunk boundaries on 16-element multiples so no cache line is shared.
+    size_t chunk = ((n + workers - 1) / workers + 15) & ~size_t(15);
+    std::vector<std::exception_ptr> errors(workers);
+    auto run = [&](size_t index, size_t begin, size_t end) {
+        try {
+            body(index, begin, end);
+        } catch (...) {
+            errors[index] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    size_t used = 0;
+    for (size_t begin = chunk; begin < n; begin += chunk) {
+        threads.emplace_back(run, ++used, begin, std::min(n, begin + chunk));
+    }
+    run(0, 0, std::min(n, chunk));
+    for (std::thread& t : threads) t.join();
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return used + 1;
+}
+
+} // namespace fractionKernels
+
+// A column of fractions in structure-of-arrays form. Arithmetic between
+// columns is element-wise and leaves results unreduced (denominator > 0,
+// no gcd); an element is only reduced on the spot when its unreduced
+// result would not fit in Int, and normalize() reduces the whole column.
+// Reading an element through operator[] always gives the reduced Fraction.
+// Like Fraction, operations throw std::overflow_error when even the reduced
+// result does not fit; the column is then left partly updated.
+template <typename Int = int>
+class FractionArray {
+    static_assert(std::is_integral<Int>::value, "FractionArray<Int> needs a built-in signed integer");
+
+    using Traits = FractionTraits<Int>;
+    using Wide = typename Traits::Wide;
+
+    std::vector<Int> numerators, denominators;
+
+    void checkSize(const FractionArray& other) const {
+        if (other.size() != size()) throw std::invalid_argument("FractionArray sizes differ.");
+    }
+
+    // Element i = num/den reduced; nothing is written if it does not fit.
+    void storeReduced(size_t i, Wide num, Wide den) {
+        Wide g = fractionGcd(num, den);
+        Int n = Traits::narrow(exactDiv(num, g));
+        Int d = Traits::narrow(exactDiv(den, g));
+        numerators[i] = n;
+        denominators[i] = d;
+    }
+
+    // Sum of one chunk. Terms accumulate unreduced in Wide while both parts
+    // stay below LIMIT, which keeps num*d + c*den from overflowing; past it
+    // the accumulator is reduced, and only if it is still that large does
+    // a term go through Fraction's exact gcd-reduced addition.
+    static Fraction<Int> sumRange(const Int* num, const Int* den, size_t n) {
+        constexpr int LIMIT_BITS = static_cast<int>(sizeof(Wide) * 8 - sizeof(Int) * 8) - 2;
+        auto large = [](Wide v) { return magnitude(v) >> LIMIT_BITS != 0; };
+
+        Wide accNum = 0, accDen = 1;
+        for (size_t i = 0; i < n; ++i) {
+            if (large(accNum) || large(accDen)) {
+                Wide g = fractionGcd(accNum, accDen);
+                accNum = exactDiv(accNum, g);
+                accDen = exactDiv(accDen, g);
+                if (large(accNum) || large(accDen)) {
+                    Fraction<Int> exact(Traits::narrow(accNum), Traits::narrow(accDen));
+                    exact += Fraction<Int>(num[i], den[i]);
+                    accNum = exact.getNumerator();
+                    accDen = exact.getDenominator();
+                    continue;
+                }
+            }
+            if (den[i] == accDen) {
+                accNum += num[i];
+            } else {
+                accNum = accNum * den[i] + static_cast<Wide>(num[i]) * accDen;
+                accDen *= den[i];
+            }
+        }
+        Wide g = fractionGcd(accNum, accDen);
+        return Fraction<Int>(Traits::narrow(exactDiv(accNum, g)), Traits::narrow(exactDiv(accDen, g)));
+    }
+
+public:
+    FractionArray() = default;
+
+    explicit FractionArray(size_t count) : numerators(count, 0), denominators(count, 1) {}
+
+    FractionArray(const std::vector<Fraction<Int>>& values) {
+        reserve(values.size());
+        for (const Fraction<Int>& f : values) push_back(f);
+    }
+
+    size_t size() const { return numerators.size(); }
+
+    void reserve(size_t count) {
+        numerators.reserve(count);
+        denominators.reserve(count);
+    }
+
+    // Appends num/den as given, only moving the sign to the numerator.
+    void push_back(Int num, Int den) {
+        if (den == 0) throw std::invalid_argument("Denominator cannot be zero.");
+        if (den < 0) {
+            if (num == std::numeric_limits<Int>::min() || den == std::numeric_limits<Int>::min()) {
+                Fraction<Int> f(num, den); // reduces first; throws if -num or -den does not fit
+                num = f.getNumerator();
+                den = f.getDenominator();
+            } else {
+                num = -num;
+                den = -den;
+            }
+        }
+        numerators.push_back(num);
+        denominators.push_back(den);
+    }
+
+    void push_back(const Fraction<Int>& f) { push_back(f.getNumerator(), f.getDenominator()); }
+
+    Fraction<Int> operator[](size_t i) const {
+        return Fraction<Int>(numerators[i], denominators[i]);
+    }
+
+    const Int* numeratorData() const { return numerators.data(); }
+    const Int* denominatorData() const { return denominators.data(); }
+
+    // this[i] += other[i]
+    FractionArray& operator+=(const FractionArray& other) {
+        checkSize(other);
+        const auto& k = fractionKernels::kernels<Int>();
+        fractionKernels::parallelFor(size(), fractionKernels::STREAM_PARALLEL_THRESHOLD,
+                                     [&](size_t, size_t begin, size_t end) {
+            Int* a = numerators.data();
+            Int* b = denominators.data();
+            const Int* c = other.numerators.data();
+            const Int* d = other.denominators.data();
+            for (size_t i = begin; i < end; ++i) {
+                i += k.add(a + i, b + i, c + i, d + i, end - i);
+                if (i == end) break;
+                Wide num, den;
+                fractionKernels::addTerms(a[i], b[i], c[i], d[i], num, den);
+                storeReduced(i, num, den);
+            }
+        });
+        return *this;
+    }
+
+    // this[i] *= other[i]
+    FractionArray& operator*=(const FractionArray& other) {
+        checkSize(other);
+        const auto& k = fractionKernels::kernels<Int>();
+        fractionKernels::parallelFor(size(), fractionKernels::STREAM_PARALLEL_THRESHOLD,
+                                     [&](size_t, size_t begin, size_t end) {
+            Int* a = numerators.data();
+            Int* b = denominators.data();
+            const Int* c = other.numerators.data();
+            const Int* d = other.denominators.data();
+            for (size_t i = begin; i < end; ++i) {
+                i += k.mul(a + i, b + i, c + i, d + i, end - i);
+                if (i == end) break;
+                storeReduced(i, static_cast<Wide>(a[i]) * c[i], static_cast<Wide>(b[i]) * d[i]);
+            }
+        });
+        return *this;
+    }
+
+    // Element-wise sign of this[i] - other[i]: -1, 0 or 1.
+    std::vector<signed char> compare(const FractionArray& other) const {
+        checkSize(other);
+        std::vector<signed char> result(size());
+        const auto& k = fractionKernels::kernels<Int>();
+        fractionKernels::parallelFor(size(), fractionKernels::STREAM_PARALLEL_THRESHOLD,
+                                     [&](size_t, size_t begin, size_t end) {
+            k.compare(numerators.data() + begin, denominators.data() + begin, other.numerators.data() + begin,
+                      other.denominators.data() + begin, result.data() + begin, end - begin);
+        });
+        return result;
+    }
+
+    // Reduce every element to lowest terms.
+    void normalize() {
+        fractionKernels::parallelFor(size(), fractionKernels::GCD_PARALLEL_THRESHOLD,
+                                     [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Wide g = fractionGcd(static_cast<Wide>(numerators[i]), static_cast<Wide>(denominators[i]));
+                if (g != 1) {
+                    numerators[i] = static_cast<Int>(numerators[i] / g);
+                    denominators[i] = static_cast<Int>(denominators[i] / g);
+                }
+            }
+        });
+    }
+
+    // Sum of all elements: one chunk per thread, then the partial sums are
+    // combined pairwise, level by level, so operands stay of similar size.
+    Fraction<Int> sum() const {
+        std::vector<Fraction<Int>> partial(fractionKernels::maxChunks());
+        size_t chunks = fractionKernels::parallelFor(size(), fractionKernels::GCD_PARALLEL_THRESHOLD,
+                                                     [&](size_t chunk, size_t begin, size_t end) {
+            partial[chunk] = sumRange(numerators.data() + begin, denominators.data() + begin, end - begin);
+        });
+        for (size_t step = 1; step < chunks; step *= 2) {
+            for (size_t i = 0; i + step < chunks; i += 2 * step) {
+                partial[i] += partial[i + step];
+            }
+        }
+        return partial[0];
+    }
+};
+
+#ifndef BENCHMARK
 int main() {
     Fraction a, b;
     std::cout << "Enter first fraction (N/D): ";
@@ -123,3 +1255,199 @@ int main() {
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -pthread -DBENCHMARK "H.W. 2 Problem 1.cpp" && ./a.out [sum terms] [harmonic terms]
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+// The pre-template Fraction arithmetic on 64-bit ints: recursive Euclid and
+// a full rebuild + simplify() per +, kept here as the baseline.
+struct LegacyFraction {
+    long long numerator, denominator;
+
+    static long long gcd(long long a, long long b) { return b == 0 ? a : gcd(b, a % b); }
+
+    LegacyFraction(long long num, long long den) : numerator(num), denominator(den) {
+        long long g = gcd(numerator, denominator);
+        numerator /= g;
+        denominator /= g;
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    LegacyFraction operator+(const LegacyFraction& other) const {
+        return LegacyFraction(numerator * other.denominator + other.numerator * denominator,
+                              denominator * other.denominator);
+    }
+};
+
+template <typename F>
+double secondsFor(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Exact H_n = 1 + 1/2 + ... + 1/n. Its denominator has about n / ln 2 bits
+// (~2250 limbs at n = 10^5), far past any built-in integer.
+static void benchHarmonic(size_t n) {
+    Fraction<BigInt> sum;
+    double seconds = secondsFor([&] {
+        for (size_t k = 1; k <= n; ++k) sum += Fraction<BigInt>(1, static_cast<long long>(k));
+    });
+    double approx = 0;
+    for (size_t k = n; k >= 1; --k) approx += 1.0 / k;
+
+    BigInt num = sum.getNumerator(), den = sum.getDenominator();
+    std::string numDigits = num.toString(), denDigits = den.toString();
+    std::cout << "H_" << n << ": " << seconds * 1e3 << " ms (" << seconds * 1e6 / n << " us/term), "
+              << numDigits.size() << "/" << denDigits.size() << " digits ("
+              << num.limbCount() << "/" << den.limbCount() << " limbs), "
+              << "leading digits " << numDigits.substr(0, 12) << ".../" << denDigits.substr(0, 12) << "..., "
+              << "double sum " << approx << "\n";
+}
+
+// Numerators in [-50, 50], denominators 1..16: the exact sum stays within
+// lcm(1..16) = 720720 times count, far beyond 32 bits.
+static std::vector<std::pair<int, int>> makeTerms(size_t count, unsigned long long seed) {
+    std::vector<std::pair<int, int>> terms(count);
+    for (auto& [num, den] : terms) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        num = static_cast<int>((seed >> 33) % 101) - 50;
+        den = static_cast<int>((seed >> 20) % 16) + 1;
+    }
+    return terms;
+}
+
+static void benchSum(size_t count) {
+    std::vector<std::pair<int, int>> terms = makeTerms(count, 12345);
+
+    LegacyFraction legacy(0, 1);
+    double legacyTime = secondsFor([&] {
+        for (const auto& [num, den] : terms) legacy = legacy + LegacyFraction(num, den);
+    });
+
+    Fraction<long long> copied;
+    double copyTime = secondsFor([&] {
+        for (const auto& [num, den] : terms) copied = copied + Fraction<long long>(num, den);
+    });
+
+    Fraction<long long> inPlace;
+    double inPlaceTime = secondsFor([&] {
+        for (const auto& [num, den] : terms) inPlace += Fraction<long long>(num, den);
+    });
+
+    size_t added = 0;
+    Fraction<int> narrow;
+    try {
+        for (const auto& [num, den] : terms) {
+            narrow += Fraction<int>(num, den);
+            ++added;
+        }
+    } catch (const std::overflow_error&) {
+    }
+
+    auto report = [count](const char* label, double seconds) {
+        std::cout << label << seconds * 1e3 << " ms (" << seconds * 1e9 / count << " ns/term)\n";
+    };
+    std::cout << "terms: " << count << "\n";
+    report("legacy a = a + b (Euclid): ", legacyTime);
+    report("Fraction<long long> a = a + b: ", copyTime);
+    report("Fraction<long long> a += b:    ", inPlaceTime);
+    std::cout << "sum: " << inPlace << " (legacy " << legacy.numerator << "/" << legacy.denominator
+              << ", match: " << (copied.getNumerator() == legacy.numerator &&
+                                 inPlace.getNumerator() == legacy.numerator &&
+                                 inPlace.getDenominator() == legacy.denominator ? "yes" : "NO")
+              << ")\n";
+    std::cout << "Fraction<int>: " << (added == count ? "no overflow" : "overflow detected after ")
+              << (added == count ? "" : std::to_string(added) + " terms") << "\n";
+}
+
+// Whole-column operations: a std::vector<Fraction> loop, which reduces
+// every result, against FractionArray, which defers the gcd to normalize().
+static void benchColumns(size_t count) {
+    std::vector<std::pair<int, int>> xTerms = makeTerms(count, 1), yTerms = makeTerms(count, 2);
+    std::vector<Fraction<int>> xs, ys;
+    FractionArray<int> xa, ya;
+    FractionArray<long long> wide;
+    xs.reserve(count);
+    ys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        xs.emplace_back(xTerms[i].first, xTerms[i].second);
+        ys.emplace_back(yTerms[i].first, yTerms[i].second);
+        xa.push_back(xTerms[i].first, xTerms[i].second);
+        ya.push_back(yTerms[i].first, yTerms[i].second);
+        wide.push_back(xTerms[i].first, xTerms[i].second);
+    }
+
+    auto report = [count](const char* label, double loopTime, double arrayTime, bool match) {
+        std::cout << label << "vector<Fraction> " << loopTime * 1e9 / count << " ns/elem, FractionArray "
+                  << arrayTime * 1e9 / count << " ns/elem (" << loopTime / arrayTime << "x)"
+                  << (match ? "" : "  MISMATCH") << "\n";
+    };
+    auto same = [count](const std::vector<Fraction<int>>& loop, const FractionArray<int>& array) {
+        for (size_t i = 0; i < count; i += 997) {
+            if (loop[i].getNumerator() != array[i].getNumerator() ||
+                loop[i].getDenominator() != array[i].getDenominator()) return false;
+        }
+        return true;
+    };
+
+    std::cout << "columns: " << count << " elements, "
+              << (fractionKernels::kernels<int>().add == fractionKernels::addPortable<int> ? "portable" : "AVX2")
+              << " kernels, " << fractionKernels::maxChunks() << " threads\n";
+
+    std::vector<Fraction<int>> sums = xs;
+    double loopTime = secondsFor([&] {
+        for (size_t i = 0; i < count; ++i) sums[i] += ys[i];
+    });
+    FractionArray<int> sumArray = xa;
+    double addTime = secondsFor([&] { sumArray += ya; });
+    double normalizeTime = secondsFor([&] { sumArray.normalize(); });
+    report("add:              ", loopTime, addTime, same(sums, sumArray));
+    report("add + normalize:  ", loopTime, addTime + normalizeTime, same(sums, sumArray));
+
+    std::vector<Fraction<int>> products = xs;
+    loopTime = secondsFor([&] {
+        for (size_t i = 0; i < count; ++i) products[i] *= ys[i];
+    });
+    FractionArray<int> productArray = xa;
+    double mulTime = secondsFor([&] { productArray *= ya; });
+    report("mul:              ", loopTime, mulTime, same(products, productArray));
+
+    // Fraction has no ordering operators; the sign of the difference is
+    // what a caller would compute.
+    std::vector<signed char> loopSigns(count);
+    loopTime = secondsFor([&] {
+        for (size_t i = 0; i < count; ++i) {
+            int num = (xs[i] - ys[i]).getNumerator();
+            loopSigns[i] = static_cast<signed char>((num > 0) - (num < 0));
+        }
+    });
+    std::vector<signed char> arraySigns;
+    double compareTime = secondsFor([&] { arraySigns = xa.compare(ya); });
+    report("compare:          ", loopTime, compareTime, loopSigns == arraySigns);
+
+    Fraction<long long> loopSum;
+    loopTime = secondsFor([&] {
+        for (const Fraction<int>& f : xs) loopSum += Fraction<long long>(f.getNumerator(), f.getDenominator());
+    });
+    Fraction<long long> arraySum;
+    double sumTime = secondsFor([&] { arraySum = wide.sum(); });
+    report("sum (long long):  ", loopTime, sumTime,
+           loopSum.getNumerator() == arraySum.getNumerator() && loopSum.getDenominator() == arraySum.getDenominator());
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t harmonicTerms = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+    benchSum(count);
+    benchColumns(count);
+    benchHarmonic(harmonicTerms);
+    return 0;
+}
+#endif
@@ -1,80 +1,524 @@
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VECTOR_MMAP 1
+#endif
+
+#include "kernel_dispatch.h"
+
+// ---- Element-wise and reduction kernels behind Vector
+//
+// Each kernel has a portable version and, on x86, an AVX2+FMA version;
+// kernels() picks once per process. Large vectors are additionally cut
+// into one contiguous chunk per hardware thread (parallelFor).
+namespace vectorKernels {
+
+struct Sum {
+    double value = 0.0;
+    double compensation = 0.0; // Kahan running error, 0 for plain sums
+};
+
+struct Kernels {
+    void (*combine)(double* out, double a, const double* x, double b, const double* y, size_t n); // out = a*x + b*y
+    void (*scale)(double* out, double s, const double* x, size_t n);                              // out = s*x
+    Sum (*dot)(const double* x, const double* y, size_t n);
+    Sum (*dotKahan)(const double* x, const double* y, size_t n);
+};
+
+// Kahan step: add v to (sum, c).
+inline void kahanAdd(double& sum, double& c, double v) {
+    double y = v - c;
+    double t = sum + y;
+    c = (t - sum) - y;
+    sum = t;
+}
+
+inline void combinePortable(double* out, double a, const double* x, double b, const double* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a * x[i] + b * y[i];
+}
+
+inline void scalePortable(double* out, double s, const double* x, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = s * x[i];
+}
+
+// Four independent accumulators, so consecutive adds do not wait on each
+// other's latency.
+inline Sum dotPortable(const double* x, const double* y, size_t n) {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc[0] += x[i] * y[i];
+        acc[1] += x[i + 1] * y[i + 1];
+        acc[2] += x[i + 2] * y[i + 2];
+        acc[3] += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) acc[0] += x[i] * y[i];
+    return {(acc[0] + acc[1]) + (acc[2] + acc[3]), 0.0};
+}
+
+inline Sum dotKahanPortable(const double* x, const double* y, size_t n) {
+    Sum total;
+    for (size_t i = 0; i < n; ++i) kahanAdd(total.value, total.compensation, x[i] * y[i]);
+    return total;
+}
+
+#ifdef KERNEL_DISPATCH_X86
+
+__attribute__((target("avx2,fma"))) inline void combineAvx2(double* out, double a, const double* x, double b,
+                                                            const double* y, size_t n) {
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d r0 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_mul_pd(vb, _mm256_loadu_pd(y + i)));
+        __m256d r1 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i + 4), _mm256_mul_pd(vb, _mm256_loadu_pd(y + i + 4)));
+        _mm256_storeu_pd(out + i, r0);
+        _mm256_storeu_pd(out + i + 4, r1);
+    }
+    for (; i < n; ++i) out[i] = a * x[i] + b * y[i];
+}
+
+__attribute__((target("avx2,fma"))) inline void scaleAvx2(double* out, double s, const double* x, size_t n) {
+    const __m256d vs = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(vs, _mm256_loadu_pd(x + i)));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(vs, _mm256_loadu_pd(x + i + 4)));
+    }
+    for (; i < n; ++i) out[i] = s * x[i];
+}
+
+__attribute__((target("avx2,fma"))) inline double horizontalSum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+// 4 vector accumulators x 4 lanes = 16 partial sums in flight, enough to
+// cover FMA latency on current cores.
+__attribute__((target("avx2,fma"))) inline Sum dotAvx2(const double* x, const double* y, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), acc3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+    }
+    double sum = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    for (; i < n; ++i) sum += x[i] * y[i];
+    return {sum, 0.0};
+}
+
+// Kahan summation per lane, two independent vector chains; the lanes are
+// folded together with Kahan steps as well.
+__attribute__((target("avx2,fma"))) inline Sum dotKahanAvx2(const double* x, const double* y, size_t n) {
+    __m256d sum0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d y0 = _mm256_fmsub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), c0);
+        __m256d t0 = _mm256_add_pd(sum0, y0);
+        c0 = _mm256_sub_pd(_mm256_sub_pd(t0, sum0), y0);
+        sum0 = t0;
+        __m256d y1 = _mm256_fmsub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), c1);
+        __m256d t1 = _mm256_add_pd(sum1, y1);
+        c1 = _mm256_sub_pd(_mm256_sub_pd(t1, sum1), y1);
+        sum1 = t1;
+    }
+    alignas(32) double sums[8], comps[8];
+    _mm256_store_pd(sums, sum0);
+    _mm256_store_pd(sums + 4, sum1);
+    _mm256_store_pd(comps, c0);
+    _mm256_store_pd(comps + 4, c1);
+    Sum total;
+    for (int lane = 0; lane < 8; ++lane) {
+        kahanAdd(total.value, total.compensation, sums[lane]);
+        kahanAdd(total.value, total.compensation, -comps[lane]);
+    }
+    for (; i < n; ++i) kahanAdd(total.value, total.compensation, x[i] * y[i]);
+    return total;
+}
+
+#endif // KERNEL_DISPATCH_X86
+
+using kernel_dispatch::Level;
+
+inline Kernels kernelsFor(Level level) {
+    return kernel_dispatch::select<Kernels>(level, {
+#ifdef KERNEL_DISPATCH_X86
+        {Level::AVX2, kernel_dispatch::AVX2 | kernel_dispatch::FMA, {combineAvx2, scaleAvx2, dotAvx2, dotKahanAvx2}},
+#endif
+        {Level::Portable, kernel_dispatch::NONE, {combinePortable, scalePortable, dotPortable, dotKahanPortable}},
+    });
+}
+
+inline const Kernels& kernels() { return kernel_dispatch::best<Kernels, kernelsFor>(); }
+
+// Below this many elements a single thread is faster than spawning more.
+const size_t PARALLEL_THRESHOLD = 1 << 20;
+
+// Calls body(chunk, begin, end) for one contiguous chunk per worker; returns
+// the number of chunks used (1 for small n).
+template <typename Body>
+size_t parallelFor(size_t n, Body&& body) {
+    size_t workers = n < PARALLEL_THRESHOLD ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    if (workers == 1) {
+        body(size_t(0), size_t(0), n);
+        return 1;
+    }
+    // Chunk boundaries on 8-element (64-byte) multiples so no cache line is shared.
+    size_t chunk = ((n + workers - 1) / workers + 7) & ~size_t(7);
+    std::vector<std::thread> threads;
+    size_t used = 0;
+    for (size_t begin = chunk; begin < n; begin += chunk) {
+        threads.emplace_back(body, ++used, begin, std::min(n, begin + chunk));
+    }
+    body(size_t(0), size_t(0), std::min(n, chunk));
+    for (std::thread& t : threads) t.join();
+    return used + 1;
+}
+
+} // namespace vectorKernels
+
+// ---- Bulk loading from files
+//
+// Text files are whitespace-separated numbers, parsed with std::from_chars
+// straight out of a memory mapping. Binary files are a 16-byte header
+// followed by the raw doubles in native byte order, so a mapping of the file
+// can serve as the vector's storage with no copy at all.
+namespace vectorIo {
+
+const char BINARY_MAGIC[8] = {'V', 'E', 'C', 'F', '6', '4', 0, 0};
+
+struct BinaryHeader {
+    char magic[8];
+    std::uint64_t count;
+};
+static_assert(sizeof(BinaryHeader) == 16, "doubles must start 8-byte aligned");
+
+// A whole file mapped into memory. Writable mappings are private: stores go
+// to copy-on-write pages and never reach the file.
+class MappedFile {
+private:
+    char* bytes = nullptr;
+    size_t length = 0;
+#ifndef VECTOR_MMAP
+    std::vector<char> buffer; // no mmap: read the file instead
+#endif
+
+public:
+    MappedFile(const std::string& path, bool writable) {
+#ifdef VECTOR_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ".");
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path + ".");
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* addr = ::mmap(nullptr, length, protection, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path + ".");
+            }
+            bytes = static_cast<char*>(addr);
+            ::madvise(addr, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd); // the mapping keeps the file alive
+#else
+        (void)writable;
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Cannot open " + path + ".");
+        length = static_cast<size_t>(in.tellg());
+        buffer.resize(length);
+        in.seekg(0);
+        in.read(buffer.data(), static_cast<std::streamsize>(length));
+        bytes = buffer.data();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef VECTOR_MMAP
+        if (bytes) ::munmap(bytes, length);
+#endif
+    }
+
+    char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// First position at or after pos where a number may begin, so that no
+// number straddles a chunk boundary.
+inline size_t tokenBoundary(const char* text, size_t n, size_t pos) {
+    while (pos > 0 && pos < n && !isSpace(text[pos - 1])) ++pos;
+    return pos;
+}
+
+// Parses [begin, end) into out; returns the offset of the first malformed
+// number, or end - begin if everything parsed.
+inline size_t parseChunk(const char* begin, const char* end, std::vector<double>& out) {
+    const char* p = begin;
+    for (;;) {
+        while (p < end && isSpace(*p)) ++p;
+        if (p == end) return end - begin;
+        const char* start = p;
+        if (*p == '+') { // accepted by operator>>, not by from_chars
+            ++p;
+            if (p < end && *p == '-') return start - begin; // "+-5": from_chars would take the '-'
+        }
+        double value;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc() || (next < end && !isSpace(*next))) return start - begin;
+        out.push_back(value);
+        p = next;
+    }
+}
+
+// Parses a whole text buffer, one chunk per hardware thread for large
+// inputs; the chunks are concatenated in order.
+inline std::vector<double> parseText(const char* text, size_t n) {
+    size_t slots = std::max(1u, std::thread::hardware_concurrency()) + 1;
+    std::vector<std::vector<double>> parts(slots);
+    std::vector<size_t> errorAt(slots, SIZE_MAX);
+    size_t chunks = vectorKernels::parallelFor(n, [&](size_t chunk, size_t begin, size_t end) {
+        begin = tokenBoundary(text, n, begin);
+        end = tokenBoundary(text, n, end);
+        if (begin >= end) return;
+        parts[chunk].reserve((end - begin) / 8);
+        size_t parsed = parseChunk(text + begin, text + end, parts[chunk]);
+        if (parsed != end - begin) errorAt[chunk] = begin + parsed;
+    });
+    for (size_t i = 0; i < chunks; ++i) {
+        if (errorAt[i] != SIZE_MAX) {
+            throw std::runtime_error("Malformed number at byte " + std::to_string(errorAt[i]) + ".");
+        }
+    }
+    if (chunks == 1) return std::move(parts[0]);
+    size_t total = 0;
+    for (size_t i = 0; i < chunks; ++i) total += parts[i].size();
+    std::vector<double> values;
+    values.reserve(total);
+    for (size_t i = 0; i < chunks; ++i) values.insert(values.end(), parts[i].begin(), parts[i].end());
+    return values;
+}
+
+} // namespace vectorIo
+
 class Vector {
 private:
-    std::vector<double> elements; // Vector elements
+    std::vector<double> elements;                 // Vector elements, unless mapped
+    std::shared_ptr<vectorIo::MappedFile> mapping; // backing file of a loadBinary() vector
+    double* first = nullptr;                       // elements.data() or into the mapping
+    size_t count = 0;
+
+    explicit Vector(std::vector<double>&& values)
+        : elements(std::move(values)), first(elements.data()), count(elements.size()) {}
+
+    // Results sized from another vector; Vector(int) would truncate past INT_MAX.
+    static Vector withSize(size_t size) {
+        return Vector(std::vector<double>(size));
+    }
+
+    bool sameSize(const Vector& other, const char* operation) const {
+        if (count != other.count) {
+            std::cerr << "Error: Vectors must be the same size for " << operation << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    // out = a*x + b*y, element-wise, split across threads for large sizes.
+    static void combine(double* out, double a, const double* x, double b, const double* y, size_t n) {
+        const auto& k = vectorKernels::kernels();
+        vectorKernels::parallelFor(n, [&](size_t, size_t begin, size_t end) {
+            k.combine(out + begin, a, x + begin, b, y + begin, end - begin);
+        });
+    }
+
+    static void scale(double* out, double s, const double* x, size_t n) {
+        const auto& k = vectorKernels::kernels();
+        vectorKernels::parallelFor(n, [&](size_t, size_t begin, size_t end) {
+            k.scale(out + begin, s, x + begin, end - begin);
+        });
+    }
 
 public:
     // Constructor with size
-    Vector(int size) : elements(size) {}
+    Vector(int size) : elements(size), first(elements.data()), count(elements.size()) {}
+
+    // Copies always own their elements, even when the source is mapped.
+    Vector(const Vector& other)
+        : elements(other.first, other.first + other.count), first(elements.data()), count(other.count) {}
+
+    Vector(Vector&& other) noexcept
+        : elements(std::move(other.elements)), mapping(std::move(other.mapping)), first(other.first), count(other.count) {
+        other.first = nullptr;
+        other.count = 0;
+    }
+
+    Vector& operator=(Vector other) noexcept {
+        elements.swap(other.elements);
+        mapping.swap(other.mapping);
+        std::swap(first, other.first);
+        std::swap(count, other.count);
+        return *this;
+    }
+
+    // Reads a text file of whitespace-separated numbers. Throws
+    // std::runtime_error if the file cannot be read or a number is malformed.
+    static Vector loadText(const std::string& path) {
+        vectorIo::MappedFile file(path, false);
+        return Vector(vectorIo::parseText(file.data(), file.size()));
+    }
+
+    // Maps a file written by saveBinary(); the elements stay in the mapping
+    // and are only paged in when touched. Writes to the vector do not
+    // change the file.
+    static Vector loadBinary(const std::string& path) {
+        auto file = std::make_shared<vectorIo::MappedFile>(path, true);
+        vectorIo::BinaryHeader header;
+        if (file->size() < sizeof header) throw std::runtime_error(path + " is not a vector file.");
+        std::memcpy(&header, file->data(), sizeof header);
+        if (std::memcmp(header.magic, vectorIo::BINARY_MAGIC, sizeof header.magic) != 0 ||
+            header.count != (file->size() - sizeof header) / sizeof(double) ||
+            (file->size() - sizeof header) % sizeof(double) != 0) {
+            throw std::runtime_error(path + " is not a vector file.");
+        }
+        Vector result(0);
+        result.first = reinterpret_cast<double*>(file->data() + sizeof header);
+        result.count = header.count;
+        result.mapping = std::move(file);
+        return result;
+    }
+
+    void saveBinary(const std::string& path) const {
+        vectorIo::BinaryHeader header;
+        std::memcpy(header.magic, vectorIo::BINARY_MAGIC, sizeof header.magic);
+        header.count = count;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof header);
+        out.write(reinterpret_cast<const char*>(first), static_cast<std::streamsize>(count * sizeof(double)));
+        if (!out) throw std::runtime_error("Cannot write " + path + ".");
+    }
+
+    size_t size() const { return count; }
+    double& operator[](size_t i) { return first[i]; }
+    const double& operator[](size_t i) const { return first[i]; }
 
     // Input operator (>>): Reads elements into the vector
     friend std::istream& operator>>(std::istream& is, Vector& v) {
-        std::cout << "Enter " << v.elements.size() << " elements:\n";
-        for (double& elem : v.elements) {
-            is >> elem;
+        for (size_t i = 0; i < v.count; ++i) {
+            is >> v.first[i];
         }
         return is;
     }
 
     // Output operator (<<): Prints vector elements
     friend std::ostream& operator<<(std::ostream& os, const Vector& v) {
-        for (double elem : v.elements) {
-            os << elem << " ";
+        for (size_t i = 0; i < v.count; ++i) {
+            os << v.first[i] << " ";
         }
         return os;
     }
 
     // Add two vectors (sizes must match)
     Vector add(const Vector& other) const {
-        if (elements.size() != other.elements.size()) {
-            std::cerr << "Error: Vectors must be the same size for addition.\n";
-            return *this;
-        }
-        Vector result(elements.size());
-        for (size_t i = 0; i < elements.size(); i++) {
-            result.elements[i] = elements[i] + other.elements[i];
-        }
+        if (!sameSize(other, "addition")) return *this;
+        Vector result = withSize(count);
+        combine(result.first, 1.0, first, 1.0, other.first, count);
         return result;
     }
 
     // Subtract two vectors (sizes must match)
     Vector subtract(const Vector& other) const {
-        if (elements.size() != other.elements.size()) {
-            std::cerr << "Error: Vectors must be the same size for subtraction.\n";
-            return *this;
-        }
-        Vector result(elements.size());
-        for (size_t i = 0; i < elements.size(); i++) {
-            result.elements[i] = elements[i] - other.elements[i];
-        }
+        if (!sameSize(other, "subtraction")) return *this;
+        Vector result = withSize(count);
+        combine(result.first, 1.0, first, -1.0, other.first, count);
         return result;
     }
 
-    // Scalar product (dot product)
-    double dotProduct(const Vector& other) const {
-        if (elements.size() != other.elements.size()) {
-            std::cerr << "Error: Vectors must be the same size for dot product.\n";
-            return 0.0;
+    // Scalar product (dot product); compensated = true uses Kahan summation,
+    // which keeps the rounding error independent of the vector length.
+    double dotProduct(const Vector& other, bool compensated = false) const {
+        if (!sameSize(other, "dot product")) return 0.0;
+        const auto& k = vectorKernels::kernels();
+        auto kernel = compensated ? k.dotKahan : k.dot;
+        const double* x = first;
+        const double* y = other.first;
+        std::vector<vectorKernels::Sum> partial(std::max(1u, std::thread::hardware_concurrency()) + 1);
+        size_t chunks = vectorKernels::parallelFor(count, [&](size_t chunk, size_t begin, size_t end) {
+            partial[chunk] = kernel(x + begin, y + begin, end - begin);
+        });
+        double sum = 0.0, c = 0.0;
+        for (size_t i = 0; i < chunks; ++i) {
+            vectorKernels::kahanAdd(sum, c, partial[i].value);
+            vectorKernels::kahanAdd(sum, c, -partial[i].compensation);
         }
-        double result = 0;
-        for (size_t i = 0; i < elements.size(); i++) {
-            result += elements[i] * other.elements[i];
-        }
-        return result;
+        return sum;
     }
 
     // Multiply vector by a scalar
     Vector multiplyByScalar(double scalar) const {
-        Vector result(elements.size());
-        for (size_t i = 0; i < elements.size(); i++) {
-            result.elements[i] = elements[i] * scalar;
-        }
+        Vector result = withSize(count);
+        scale(result.first, scalar, first, count);
         return result;
     }
+
+    // In-place versions: no temporary vector, one pass over memory
+    Vector& operator+=(const Vector& other) {
+        return axpby(1.0, other, 1.0);
+    }
+
+    Vector& operator-=(const Vector& other) {
+        return axpby(-1.0, other, 1.0);
+    }
+
+    Vector& operator*=(double scalar) {
+        scale(first, scalar, first, count);
+        return *this;
+    }
+
+    // this += a * x
+    Vector& axpy(double a, const Vector& x) {
+        return axpby(a, x, 1.0);
+    }
+
+    // this = a * x + b * this
+    Vector& axpby(double a, const Vector& x, double b) {
+        if (!sameSize(x, "axpby")) return *this;
+        combine(first, a, x.first, b, first, count);
+        return *this;
+    }
 };
 
+#ifndef BENCHMARK
 int main() {
     int size1, size2;
 
@@ -82,12 +526,14 @@ int main() {
     std::cout << "Enter the size of Vector 1:\n";
     std::cin >> size1;
     Vector v1(size1);
+    std::cout << "Enter " << size1 << " elements:\n";
     std::cin >> v1;
 
     // Input size of Vector 2
     std::cout << "Enter the size of Vector 2:\n";
     std::cin >> size2;
     Vector v2(size2);
+    std::cout << "Enter " << size2 << " elements:\n";
     std::cin >> v2;
 
     // Check sizes and perform operations
@@ -108,3 +554,128 @@ int main() {
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -pthread -DBENCHMARK "H.W. 2 Problem 2.cpp" && ./a.out [elements]
+//                                                          ./a.out load [elements]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+// The pre-kernel Vector methods: a new std::vector per add and a dot
+// product with one accumulator.
+std::vector<double> legacyAdd(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> result(a.size());
+    for (size_t i = 0; i < a.size(); i++) result[i] = a[i] + b[i];
+    return result;
+}
+
+double legacyDot(const std::vector<double>& a, const std::vector<double>& b) {
+    double result = 0;
+    for (size_t i = 0; i < a.size(); i++) result += a[i] * b[i];
+    return result;
+}
+
+template <typename F>
+double bestSeconds(int repeats, F&& body) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void benchSize(size_t n) {
+    const int repeats = n > 1000000 ? 5 : 50;
+    std::vector<double> a(n), b(n);
+    Vector va(static_cast<int>(n)), vb(static_cast<int>(n));
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = va[i] = 1.0 / (i + 1);
+        b[i] = vb[i] = (i % 7) * 0.25 - 0.5;
+    }
+
+    double sink = 0;
+    auto row = [&](const char* label, double bytes, double seconds) {
+        std::cout << "  " << label << seconds * 1e3 << " ms, " << bytes / seconds / 1e9 << " GB/s\n";
+    };
+    const double three = 3.0 * n * sizeof(double), two = 2.0 * n * sizeof(double);
+
+    std::cout << "n = " << n << " (" << std::thread::hardware_concurrency() << " hardware threads)\n";
+    row("legacy add (new vector):   ", three, bestSeconds(repeats, [&] { sink += legacyAdd(a, b)[n / 2]; }));
+    row("Vector::add (new vector):  ", three, bestSeconds(repeats, [&] { sink += va.add(vb)[n / 2]; }));
+    row("Vector += (in place):      ", three, bestSeconds(repeats, [&] { va += vb; sink += va[n / 2]; }));
+    row("Vector axpy(0.5, x):       ", three, bestSeconds(repeats, [&] { va.axpy(0.5, vb); sink += va[n / 2]; }));
+    row("Vector *= 0.999:           ", two, bestSeconds(repeats, [&] { va *= 0.999; sink += va[n / 2]; }));
+    row("legacy dot (1 accumulator):", two, bestSeconds(repeats, [&] { sink += legacyDot(a, b); }));
+    row("Vector::dotProduct:        ", two, bestSeconds(repeats, [&] { sink += va.dotProduct(vb); }));
+    row("Vector::dotProduct Kahan:  ", two, bestSeconds(repeats, [&] { sink += va.dotProduct(vb, true); }));
+    std::cout << "  (sink " << sink << ")\n";
+}
+
+// Writes n values as text and as binary to the temp directory, then loads
+// them back through operator>>, loadText and loadBinary.
+void benchLoad(size_t n) {
+    namespace fs = std::filesystem;
+    const std::string textPath = (fs::temp_directory_path() / "vector_bench.txt").string();
+    const std::string binaryPath = (fs::temp_directory_path() / "vector_bench.bin").string();
+
+    Vector source(static_cast<int>(n));
+    for (size_t i = 0; i < n; ++i) source[i] = (static_cast<double>(i % 1000003) - 500000.0) / 7.0;
+    {
+        std::ofstream out(textPath);
+        char buffer[32];
+        for (size_t i = 0; i < n; ++i) {
+            char* end = std::to_chars(buffer, buffer + sizeof buffer, source[i]).ptr;
+            *end++ = (i % 8 == 7) ? '\n' : ' ';
+            out.write(buffer, end - buffer);
+        }
+    }
+    source.saveBinary(binaryPath);
+    const double textBytes = static_cast<double>(fs::file_size(textPath));
+    const double expected = source.dotProduct(source);
+
+    double sink = 0;
+    auto row = [&](const char* label, double seconds, const Vector& loaded) {
+        std::cout << "  " << label << seconds * 1e3 << " ms, " << n / seconds / 1e6 << " M elements/s, "
+                  << textBytes / seconds / 1e6 << " MB/s of text" << (loaded.dotProduct(loaded) == expected ? "" : "  MISMATCH")
+                  << "\n";
+    };
+
+    std::cout << "load n = " << n << " (" << textBytes / 1e6 << " MB text, " << std::thread::hardware_concurrency()
+              << " hardware threads)\n";
+    Vector viaStream(static_cast<int>(n));
+    row("istream operator>>:       ", bestSeconds(1, [&] {
+            std::ifstream in(textPath);
+            in >> viaStream;
+        }), viaStream);
+    Vector viaText(0);
+    row("Vector::loadText:         ", bestSeconds(3, [&] { viaText = Vector::loadText(textPath); }), viaText);
+    Vector viaBinary(0);
+    row("Vector::loadBinary:       ", bestSeconds(3, [&] { viaBinary = Vector::loadBinary(binaryPath); }), viaBinary);
+    row("loadBinary + first pass:  ", bestSeconds(3, [&] {
+            Vector v = Vector::loadBinary(binaryPath);
+            sink += v.dotProduct(v);
+        }), viaBinary);
+    std::cout << "  (sink " << sink << ")\n";
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "load") {
+        benchLoad(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000);
+        return 0;
+    }
+    if (argc > 1) {
+        benchSize(std::strtoull(argv[1], nullptr, 10));
+        return 0;
+    }
+    benchSize(100000);
+    benchSize(10000000);
+    benchLoad(10000000);
+    return 0;
+}
+#endif
@@ -0,0 +1,7 @@
+#ifndef MY_DEQUE_ADAPTER_H
+#define MY_DEQUE_ADAPTER_H
+
+// MyDeque lives in "1 deque.cpp"; StackAdapter includes it by this name.
+#include "1 deque.cpp"
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef CONTAINER_STATS_H
+#define CONTAINER_STATS_H
+
+// Opt-in allocation and operation counters for the containers in this
+// repository. Build with -DCONTAINER_STATS to turn them on; without it every
+// hook below is an empty inline function and compiles away.
+//
+// Counters are kept per instantiated type (Deque<int> and Deque<std::string>
+// are separate rows) in per-thread shards: the owning thread is the only
+// writer, so a hook is a relaxed load and store with no contention.
+// snapshot() sums the live shards plus whatever exited threads left behind.
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef CONTAINER_STATS
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#endif
+
+namespace container_stats {
+
+#ifdef CONTAINER_STATS
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+enum Counter : unsigned {
+    ALLOCATIONS, // calls into the allocator
+    BYTES,       // bytes requested by those calls
+    COPIES,      // copies, and moves that had to copy (unequal allocators)
+    MOVES,       // moves that took over the other side's storage
+    REGROWTHS,   // a map or buffer replaced by a larger one
+    COUNTER_KINDS
+};
+
+struct TypeCounters {
+    std::string type;
+    uint64_t values[COUNTER_KINDS] = {};
+
+    uint64_t operator[](Counter c) const { return values[c]; }
+};
+
+// Counts for `after` minus `before`, matched by type name; for measuring
+// one stretch of code between two snapshots.
+inline std::vector<TypeCounters> difference(const std::vector<TypeCounters>& after,
+                                            const std::vector<TypeCounters>& before) {
+    std::vector<TypeCounters> result;
+    for (const TypeCounters& row : after) {
+        TypeCounters delta = row;
+        for (const TypeCounters& old : before) {
+            if (old.type == row.type) {
+                for (unsigned c = 0; c < COUNTER_KINDS; ++c) {
+                    delta.values[c] -= old.values[c];
+                }
+                break;
+            }
+        }
+        result.push_back(delta);
+    }
+    return result;
+}
+
+inline void print(std::ostream& out, const std::vector<TypeCounters>& rows) {
+    out << "allocations\tbytes\tcopies\tmoves\tregrowths\ttype\n";
+    for (const TypeCounters& row : rows) {
+        for (unsigned c = 0; c < COUNTER_KINDS; ++c) {
+            out << row.values[c] << "\t";
+        }
+        out << row.type << "\n";
+    }
+}
+
+#ifdef CONTAINER_STATS
+
+namespace detail {
+
+// Types past this share the last row.
+constexpr unsigned MAX_TYPES = 64;
+
+struct Shard;
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<Shard*> shards;
+    uint64_t retired[MAX_TYPES][COUNTER_KINDS] = {}; // from threads that have exited
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct Shard {
+    std::atomic<uint64_t> values[MAX_TYPES][COUNTER_KINDS] = {};
+
+    Shard() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.shards.push_back(this);
+    }
+
+    ~Shard() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (unsigned t = 0; t < MAX_TYPES; ++t) {
+            for (unsigned c = 0; c < COUNTER_KINDS; ++c) {
+                r.retired[t][c] += values[t][c].load(std::memory_order_relaxed);
+            }
+        }
+        r.shards.erase(std::find(r.shards.begin(), r.shards.end(), this));
+    }
+
+    void add(unsigned type, Counter c, uint64_t n) {
+        std::atomic<uint64_t>& v = values[type][c];
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+inline Shard& shard() {
+    thread_local Shard local;
+    return local;
+}
+
+inline unsigned register_type(std::string_view name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (r.names.size() == MAX_TYPES - 1) {
+        r.names.push_back("(other types)");
+    }
+    if (r.names.size() == MAX_TYPES) {
+        return MAX_TYPES - 1;
+    }
+    r.names.emplace_back(name);
+    return static_cast<unsigned>(r.names.size() - 1);
+}
+
+// "Deque<int>" out of this function's signature.
+template <typename Owner>
+std::string_view type_name() {
+    std::string_view signature = __PRETTY_FUNCTION__;
+    size_t begin = signature.find("Owner = ");
+    if (begin == std::string_view::npos) {
+        return signature;
+    }
+    begin += 8;
+    size_t end = signature.find_first_of(";]", begin);
+    return signature.substr(begin, end - begin);
+}
+
+template <typename Owner>
+unsigned type_id() {
+    static const unsigned id = register_type(type_name<Owner>());
+    return id;
+}
+
+} // namespace detail
+
+template <typename Owner>
+inline void count(Counter c, uint64_t n = 1) {
+    detail::shard().add(detail::type_id<Owner>(), c, n);
+}
+
+inline std::vector<TypeCounters> snapshot() {
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<TypeCounters> result(r.names.size());
+    for (size_t t = 0; t < result.size(); ++t) {
+        result[t].type = r.names[t];
+        for (unsigned c = 0; c < COUNTER_KINDS; ++c) {
+            uint64_t sum = r.retired[t][c];
+            for (const detail::Shard* s : r.shards) {
+                sum += s->values[t][c].load(std::memory_order_relaxed);
+            }
+            result[t].values[c] = sum;
+        }
+    }
+    return result;
+}
+
+#else
+
+template <typename Owner>
+inline void count(Counter, uint64_t = 1) {}
+
+inline std::vector<TypeCounters> snapshot() { return {}; }
+
+#endif
+
+template <typename Owner>
+inline void count_allocation(size_t bytes) {
+    count<Owner>(ALLOCATIONS);
+    count<Owner>(BYTES, bytes);
+}
+
+} // namespace container_stats
+
+#endif
@@ -0,0 +1,3 @@
+// Deque half of "second semester - problems 1 and 2", under the name its
+// Stack half includes it by.
+#include "second semester - problems 1 and 2"
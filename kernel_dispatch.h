@@ -0,0 +1,73 @@
+#ifndef KERNEL_DISPATCH_H
+#define KERNEL_DISPATCH_H
+
+// Runtime choice between a file's portable kernels and its SIMD ones. Each
+// file keeps its own Kernels table of function pointers and lists the tables
+// it has, widest first, each with the CPU features it needs; select() returns
+// the first one the CPU can run and best() caches that choice per process.
+//
+// KERNEL_DISPATCH_X86 is defined (and <immintrin.h> included) on x86 builds;
+// files guard their intrinsic kernels with it.
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNEL_DISPATCH_X86 1
+#endif
+
+namespace kernel_dispatch {
+
+enum class Level { Portable, SSE2, AVX2 };
+
+enum Feature : unsigned {
+    NONE = 0,
+    SSE2 = 1u << 0,
+    AVX2 = 1u << 1,
+    FMA = 1u << 2,
+    BMI = 1u << 3,
+};
+
+// True if the CPU has every feature in `features`. Off x86 only NONE holds.
+inline bool cpu_has(unsigned features) {
+#ifdef KERNEL_DISPATCH_X86
+    __builtin_cpu_init();
+    return (!(features & SSE2) || __builtin_cpu_supports("sse2")) &&
+           (!(features & AVX2) || __builtin_cpu_supports("avx2")) &&
+           (!(features & FMA) || __builtin_cpu_supports("fma")) &&
+           (!(features & BMI) || __builtin_cpu_supports("bmi"));
+#else
+    return features == NONE;
+#endif
+}
+
+template <typename Kernels>
+struct Candidate {
+    Level level;
+    unsigned needs;
+    Kernels kernels;
+};
+
+// The first candidate no wider than `level` that the CPU can run; levels it
+// cannot run fall back to the next narrower one. The last candidate must be
+// the portable table, which needs NONE.
+template <typename Kernels>
+Kernels select(Level level, std::initializer_list<Candidate<Kernels>> candidates) {
+    for (const Candidate<Kernels>& candidate : candidates) {
+        if (candidate.level <= level && cpu_has(candidate.needs)) {
+            return candidate.kernels;
+        }
+    }
+    return (candidates.end() - 1)->kernels;
+}
+
+// The widest kernels `kernels_for` finds, chosen on first use.
+template <typename Kernels, Kernels (*kernels_for)(Level)>
+const Kernels& best() {
+    static const Kernels chosen = kernels_for(Level::AVX2);
+    return chosen;
+}
+
+} // namespace kernel_dispatch
+
+#endif
@@ -1,32 +1,416 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
 #include <iostream>
-#include <unordered_map>
-#include <vector>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-// Function to find the k-th distinct string
-std::string kthDistinct(std::vector<std::string>& arr, int k) {
-    std::unordered_map<std::string, int> cnt;
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DISTINCT_MMAP 1
+#endif
 
-    // Count occurrences of each string in the array
-    for (const auto& s : arr) {
-        ++cnt[s];
+// ---- Counting strings without copying them
+//
+// DistinctTable is an open-addressing (linear probing) table whose entries
+// hold a string's hash, the position of its first occurrence and a count
+// that saturates at 2 -- "once" or "more than once" is all kthDistinct
+// needs. The strings themselves stay wherever they already are; the caller
+// passes a comparison that looks them up by position.
+namespace distinct {
+
+inline std::uint64_t hashBytes(const char* p, size_t n) {
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ (n * 0xFF51AFD7ED558CCDull);
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
     }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, p, n);
+    h = (h ^ tail) * 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 32);
+}
 
-    // Find the k-th distinct string in the order they appear
-    for (const auto& s : arr) {
-        if (cnt[s] == 1) { // Check if the string is distinct
-            --k;
-            if (k == 0) {
-                return s; // Return the k-th distinct string
+class DistinctTable {
+public:
+    struct Entry {
+        std::uint64_t hash;
+        std::uint64_t position; // first occurrence (byte offset or index)
+        std::uint32_t length;
+        std::uint32_t count;    // 0 = empty slot, otherwise 1 or 2 (= "2 or more")
+    };
+
+private:
+    std::vector<Entry> slots;
+    size_t used = 0;
+
+    void grow() {
+        std::vector<Entry> old(slots.size() * 2, Entry{0, 0, 0, 0});
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (const Entry& e : old) {
+            if (e.count == 0) continue;
+            size_t i = e.hash & mask;
+            while (slots[i].count != 0) i = (i + 1) & mask;
+            slots[i] = e;
+        }
+    }
+
+public:
+    explicit DistinctTable(size_t expected = 1024) {
+        size_t capacity = 16;
+        while (capacity < expected + expected / 2) capacity *= 2;
+        slots.assign(capacity, Entry{0, 0, 0, 0});
+    }
+
+    // Records `count` occurrences of the string at `position` and returns
+    // its entry (valid until the next add). same(a, b, length) must say
+    // whether the strings at positions a and b are equal; it is only called
+    // when hash and length already match.
+    template <typename Same>
+    const Entry& add(std::uint64_t hash, std::uint64_t position, std::uint32_t length, std::uint32_t count, Same&& same) {
+        if ((used + 1) * 10 > slots.size() * 7) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Entry& e = slots[i];
+            if (e.count == 0) {
+                e = {hash, position, length, std::min<std::uint32_t>(count, 2)};
+                ++used;
+                return e;
+            }
+            if (e.hash == hash && e.length == length && same(e.position, position, length)) {
+                e.count = std::min<std::uint32_t>(e.count + count, 2);
+                e.position = std::min(e.position, position);
+                return e;
+            }
+        }
+    }
+
+    // Starts loading the slot a hash probes first. Callers hash a batch of
+    // strings, prefetch them all, then add them, so the cache misses of the
+    // batch overlap instead of queueing one after another.
+    void prefetch(std::uint64_t hash) const {
+        __builtin_prefetch(&slots[hash & (slots.size() - 1)]);
+    }
+
+    const std::vector<Entry>& entries() const { return slots; }
+    size_t size() const { return used; }
+};
+
+const size_t BATCH = 16;
+
+// Picks the k-th smallest position among the strings seen exactly once;
+// returns false if there are fewer than k of them.
+inline bool kthSingleton(std::vector<std::uint64_t>& singles, int k, std::uint64_t& position) {
+    if (k <= 0 || singles.size() < static_cast<size_t>(k)) return false;
+    std::nth_element(singles.begin(), singles.begin() + (k - 1), singles.end());
+    position = singles[k - 1];
+    return true;
+}
+
+// A whole file mapped read-only (or read into memory where mmap is missing).
+class MappedFile {
+private:
+    char* bytes = nullptr;
+    size_t length = 0;
+#ifndef DISTINCT_MMAP
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef DISTINCT_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ".");
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path + ".");
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path + ".");
             }
+            bytes = static_cast<char*>(addr);
         }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Cannot open " + path + ".");
+        length = static_cast<size_t>(in.tellg());
+        buffer.resize(length);
+        in.seekg(0);
+        in.read(buffer.data(), static_cast<std::streamsize>(length));
+        bytes = buffer.data();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef DISTINCT_MMAP
+        if (bytes) ::munmap(bytes, length);
+#endif
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// How a file is cut into strings: whitespace-separated words (what
+// std::cin >> reads) or whole lines.
+enum class Split { Words, Lines };
+
+inline bool isSeparator(char c, Split split) {
+    if (split == Split::Lines) return c == '\n';
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Below this many bytes one thread does the whole file.
+const size_t PARALLEL_THRESHOLD = 1 << 22;
+
+} // namespace distinct
+
+// Function to find the k-th distinct string
+std::string kthDistinct(std::vector<std::string>& arr, int k) {
+    // Each string is hashed once; the table remembers its first index, so
+    // the ordered pass only has to look at the strings that occur once.
+    distinct::DistinctTable cnt(arr.size());
+    auto same = [&](std::uint64_t a, std::uint64_t b, std::uint32_t) { return arr[a] == arr[b]; };
+    std::uint64_t hashes[distinct::BATCH];
+    for (size_t base = 0; base < arr.size(); base += distinct::BATCH) {
+        size_t batch = std::min(distinct::BATCH, arr.size() - base);
+        for (size_t j = 0; j < batch; ++j) {
+            hashes[j] = distinct::hashBytes(arr[base + j].data(), arr[base + j].size());
+            cnt.prefetch(hashes[j]);
+        }
+        for (size_t j = 0; j < batch; ++j) {
+            cnt.add(hashes[j], base + j, static_cast<std::uint32_t>(arr[base + j].size()), 1, same);
+        }
+    }
+
+    // Find the k-th distinct string in the order they appear
+    std::vector<std::uint64_t> singles;
+    for (const auto& e : cnt.entries()) {
+        if (e.count == 1) singles.push_back(e.position);
+    }
+    std::uint64_t position;
+    if (distinct::kthSingleton(singles, k, position)) {
+        return arr[position];
     }
 
     // If fewer than k distinct strings, return an empty string
     return "";
 }
 
-int main() {
+// k-th distinct string of a file, without reading it into strings. The
+// file is mapped and cut into one chunk per hardware thread; each thread
+// counts its chunk into its own table, then the tables are merged in
+// parallel with thread s owning every hash with hash % shards == s. Memory
+// does not grow with the file size, only with the number of distinct
+// strings: every thread's table may hold all of them and the shard tables
+// hold them once more, so at most (threads + 1) entries of 24 bytes each.
+// Throws std::runtime_error if the file cannot be read.
+std::string kthDistinctInFile(const std::string& path, int k, distinct::Split split = distinct::Split::Words) {
+    using distinct::DistinctTable;
+    distinct::MappedFile file(path);
+    const char* text = file.data();
+    const size_t n = file.size();
+
+    auto same = [&](std::uint64_t a, std::uint64_t b, std::uint32_t length) {
+        return std::memcmp(text + a, text + b, length) == 0;
+    };
+
+    size_t workers = n < distinct::PARALLEL_THRESHOLD ? 1 : std::max(1u, std::thread::hardware_concurrency());
+
+    // Pass 1: count each chunk. Chunk boundaries move forward to the start
+    // of a string so that no string is split between two threads.
+    auto boundary = [&](size_t pos) {
+        while (pos > 0 && pos < n && !distinct::isSeparator(text[pos - 1], split)) ++pos;
+        return std::min(pos, n);
+    };
+    std::vector<DistinctTable> local(workers);
+    auto countChunk = [&](size_t w) {
+        size_t begin = boundary(n / workers * w);
+        size_t end = w + 1 == workers ? n : boundary(n / workers * (w + 1));
+        DistinctTable& table = local[w];
+        std::uint64_t hashes[distinct::BATCH];
+        size_t starts[distinct::BATCH], lengths[distinct::BATCH];
+        size_t batch = 0;
+        auto flush = [&] {
+            for (size_t j = 0; j < batch; ++j) {
+                table.add(hashes[j], starts[j], static_cast<std::uint32_t>(lengths[j]), 1, same);
+            }
+            batch = 0;
+        };
+        for (size_t i = begin; i < end;) {
+            if (distinct::isSeparator(text[i], split)) {
+                ++i;
+                continue;
+            }
+            size_t start = i;
+            while (i < end && !distinct::isSeparator(text[i], split)) ++i;
+            size_t len = i - start;
+            if (split == distinct::Split::Lines && text[i - 1] == '\r') --len; // CRLF files
+            if (len == 0) continue; // a blank CRLF line, skipped like a blank LF one
+            hashes[batch] = distinct::hashBytes(text + start, len);
+            table.prefetch(hashes[batch]);
+            starts[batch] = start;
+            lengths[batch] = len;
+            if (++batch == distinct::BATCH) flush();
+        }
+        flush();
+    };
+
+    // Pass 2: merge shard s of every local table and keep its singletons.
+    std::vector<std::vector<std::uint64_t>> singles(workers);
+    auto mergeShard = [&](size_t s) {
+        if (workers == 1) {
+            for (const auto& e : local[0].entries()) {
+                if (e.count == 1) singles[0].push_back(e.position);
+            }
+            return;
+        }
+        DistinctTable shard(local[0].size() / workers);
+        for (const DistinctTable& table : local) { // chunk order, so the first insert has the first position
+            for (const auto& e : table.entries()) {
+                if (e.count != 0 && e.hash % workers == s) shard.add(e.hash, e.position, e.length, e.count, same);
+            }
+        }
+        for (const auto& e : shard.entries()) {
+            if (e.count == 1) singles[s].push_back(e.position);
+        }
+    };
+
+    auto runAll = [&](auto& body) {
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < workers; ++w) threads.emplace_back(body, w);
+        body(size_t(0));
+        for (std::thread& t : threads) t.join();
+    };
+    runAll(countChunk);
+    runAll(mergeShard);
+    local.clear();
+
+    // The answer is the k-th smallest first-occurrence offset among singletons.
+    std::vector<std::uint64_t> all;
+    for (auto& part : singles) all.insert(all.end(), part.begin(), part.end());
+    std::uint64_t position;
+    if (!distinct::kthSingleton(all, k, position)) return "";
+    size_t end = position;
+    while (end < n && !distinct::isSeparator(text[end], split)) ++end;
+    if (split == distinct::Split::Lines && end > position && text[end - 1] == '\r') --end;
+    return std::string(text + position, end - position);
+}
+
+// Answers kthDistinct for any k in O(log n) over a growing list of strings.
+// Each distinct string is stored once and numbered in order of first
+// appearance, which is the order kthDistinct counts them in. A Fenwick tree
+// over the ids holds one live bit per id: appending a new string adds a live
+// id, a second copy clears its bit, and kth(k) descends the tree to the k-th
+// live id. Every operation is O(log n), however appends and queries mix.
+class DistinctIndex {
+private:
+    std::deque<std::string> strings;        // by id; a deque keeps references stable
+    std::vector<std::uint8_t> repeated;     // by id
+    distinct::DistinctTable table{16};      // hash -> id
+    std::vector<std::uint32_t> live{0};     // Fenwick tree, 1-based: live[i] counts live ids in (i - lowbit(i), i]
+    size_t singleCount = 0;
+    size_t total = 0;
+
+    static size_t lowbit(size_t i) { return i & (~i + 1); }
+
+    // Appends a live id; its node sums the nodes it covers.
+    void pushLive() {
+        const size_t i = live.size();
+        std::uint32_t sum = 1;
+        for (size_t j = i - 1, stop = i - lowbit(i); j > stop; j -= lowbit(j)) sum += live[j];
+        live.push_back(sum);
+        ++singleCount;
+    }
+
+    void kill(std::uint32_t id) {
+        for (size_t i = size_t(id) + 1; i < live.size(); i += lowbit(i)) --live[i];
+        --singleCount;
+    }
+
+public:
+    DistinctIndex() = default;
+
+    explicit DistinctIndex(const std::vector<std::string>& arr) {
+        for (const auto& s : arr) append(s);
+    }
+
+    void append(std::string_view s) {
+        const std::uint32_t next = static_cast<std::uint32_t>(strings.size());
+        auto view = [&](std::uint64_t id) { return id == next ? s : std::string_view(strings[id]); };
+        auto same = [&](std::uint64_t a, std::uint64_t b, std::uint32_t) { return view(a) == view(b); };
+        const auto& entry = table.add(distinct::hashBytes(s.data(), s.size()), next,
+                                      static_cast<std::uint32_t>(s.size()), 1, same);
+        ++total;
+        std::uint32_t id = static_cast<std::uint32_t>(entry.position);
+        if (id == next) { // first occurrence: a new singleton, and the latest one
+            strings.emplace_back(s);
+            repeated.push_back(0);
+            pushLive();
+        } else if (!repeated[id]) { // second occurrence: no longer distinct
+            repeated[id] = 1;
+            kill(id);
+        }
+    }
+
+    size_t size() const { return total; }
+
+    size_t distinctCount() const { return singleCount; }
+
+    // The k-th (1-based) distinct string, or "" if there are fewer than k.
+    // The reference stays valid across later appends.
+    const std::string& kth(int k) const {
+        static const std::string none;
+        if (k <= 0 || static_cast<size_t>(k) > singleCount) return none;
+        size_t pos = 0, rest = static_cast<size_t>(k);
+        for (size_t step = std::bit_floor(live.size() - 1); step; step >>= 1) {
+            if (pos + step < live.size() && live[pos + step] < rest) {
+                pos += step;
+                rest -= live[pos];
+            }
+        }
+        return strings[pos]; // id pos is node pos + 1
+    }
+};
+
+#ifndef BENCHMARK
+int main(int argc, char** argv) {
+    // Usage: ./a.out <file> <k> reads the strings from a file instead.
+    if (argc == 3) {
+        int k = std::atoi(argv[2]);
+        std::string result = kthDistinctInFile(argv[1], k);
+        if (result.empty()) {
+            std::cout << "There are fewer than " << k << " distinct strings in the file.\n";
+        } else {
+            std::cout << "The " << k << "-th distinct string in the file is: " << result << "\n";
+        }
+        return 0;
+    }
+
     int n, k;
     std::cout << "Enter the number of strings in the array: ";
     std::cin >> n;
@@ -55,4 +439,162 @@ int main() {
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -pthread -DBENCHMARK "problem 1 .cpp" && ./a.out [strings]
+//                                                         ./a.out queries [strings]
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <unordered_map>
 
+// The original two-pass version over std::unordered_map<std::string, int>.
+std::string legacyKthDistinct(std::vector<std::string>& arr, int k) {
+    std::unordered_map<std::string, int> cnt;
+    for (const auto& s : arr) ++cnt[s];
+    for (const auto& s : arr) {
+        if (cnt[s] == 1 && --k == 0) return s;
+    }
+    return "";
+}
+
+template <typename F>
+double seconds(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// n log-like words drawn from n / 2 keys, so about a seventh occur once.
+void benchStrings(size_t n) {
+    const std::string path = (std::filesystem::temp_directory_path() / "kth_distinct_bench.txt").string();
+    {
+        std::ofstream out(path);
+        std::uint64_t state = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i) {
+            state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+            out << "session-" << state % (n / 2 + 1) << (i % 8 == 7 ? '\n' : ' ');
+        }
+    }
+    const double mb = std::filesystem::file_size(path) / 1e6;
+    const int k = static_cast<int>(n / 20) + 1;
+
+    std::string a, b, c;
+    std::vector<std::string> arr;
+    std::cout << "n = " << n << " (" << mb << " MB, " << std::thread::hardware_concurrency() << " hardware threads)\n";
+    double read = seconds([&] {
+        std::ifstream in(path);
+        std::string s;
+        while (in >> s) arr.push_back(s);
+    });
+    std::cout << "  read into std::vector<string>:  " << read * 1e3 << " ms\n";
+    std::cout << "  legacy kthDistinct (in memory): " << seconds([&] { a = legacyKthDistinct(arr, k); }) * 1e3 << " ms\n";
+    std::cout << "  kthDistinct (in memory):        " << seconds([&] { b = kthDistinct(arr, k); }) * 1e3 << " ms\n";
+    double streamed = seconds([&] { c = kthDistinctInFile(path, k); });
+    std::cout << "  kthDistinctInFile:              " << streamed * 1e3 << " ms, " << mb / streamed << " MB/s"
+              << (a == b && b == c ? "" : "  MISMATCH") << "\n";
+    std::remove(path.c_str());
+}
+
+// 10^6 queries with varying k against one array: DistinctIndex versus a
+// kthDistinct call per query (timed on a sample and scaled up).
+void benchQueries(size_t n) {
+    const size_t queries = 1000000, sample = 200;
+    std::vector<std::string> arr;
+    std::uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        arr.push_back("session-" + std::to_string(state % (n / 2 + 1)));
+    }
+
+    DistinctIndex index;
+    double build = seconds([&] { index = DistinctIndex(arr); });
+    const size_t distinctCount = index.distinctCount();
+    auto kFor = [&](size_t q) { return static_cast<int>(q * 7919 % (distinctCount + 1) + 1); };
+
+    size_t sink = 0;
+    double indexed = seconds([&] {
+        for (size_t q = 0; q < queries; ++q) sink += index.kth(kFor(q)).size();
+    });
+    bool same = true;
+    double repeated = seconds([&] {
+        for (size_t q = 0; q < sample; ++q) {
+            std::string s = kthDistinct(arr, kFor(q));
+            same = same && s == index.kth(kFor(q));
+        }
+    }) / sample * queries;
+
+    // Appending keeps the index current; time a second half of the stream.
+    double appendSeconds = seconds([&] {
+        for (size_t i = 0; i < n; ++i) index.append(arr[(i * 31) % n]);
+    });
+    std::vector<std::string> doubled(arr);
+    for (size_t i = 0; i < n; ++i) doubled.push_back(arr[(i * 31) % n]);
+    same = same && index.kth(1) == kthDistinct(doubled, 1);
+
+    std::cout << "n = " << n << ", " << distinctCount << " distinct, " << queries << " queries\n";
+    std::cout << "  DistinctIndex build:            " << build * 1e3 << " ms\n";
+    std::cout << "  DistinctIndex::kth x 10^6:      " << indexed * 1e3 << " ms\n";
+    std::cout << "  kthDistinct x 10^6 (estimated): " << repeated * 1e3 << " ms\n";
+    std::cout << "  " << n << " further appends:         " << appendSeconds * 1e3 << " ms"
+              << (same ? "" : "  MISMATCH") << "\n";
+    std::cout << "  (sink " << sink << ")\n";
+}
+
+// Appends that kill early ids interleaved with queries, the mix that made
+// the old sweep-on-query index quadratic: n distinct strings, then n rounds
+// of append(copy of string i) + kth(1). With O(log n) operations the cost
+// per round barely moves from n to 4n. A random mix of appends and queries
+// is also checked against kthDistinct on the same prefix.
+void benchInterleaved(size_t n) {
+    bool same = true;
+    double perRound[2];
+    for (int run = 0; run < 2; ++run) {
+        const size_t count = run == 0 ? n : 4 * n;
+        std::vector<std::string> words(count);
+        for (size_t i = 0; i < count; ++i) words[i] = "word-" + std::to_string(i);
+        DistinctIndex index(words);
+        perRound[run] = seconds([&] {
+            for (size_t i = 0; i < count; ++i) {
+                index.append(words[i]);
+                same = same && index.kth(1) == (i + 1 < count ? words[i + 1] : std::string());
+            }
+        }) / count;
+    }
+
+    std::vector<std::string> prefix;
+    DistinctIndex index;
+    std::uint64_t state = 88172645463325252ull;
+    for (size_t step = 0; step < 4000 && same; ++step) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        if (state % 3) {
+            prefix.push_back("w" + std::to_string(state % 500));
+            index.append(prefix.back());
+        } else {
+            int k = static_cast<int>(state / 3 % (index.distinctCount() + 2)) + 1;
+            same = index.kth(k) == kthDistinct(prefix, k);
+        }
+    }
+
+    std::cout << "interleaved append + kth(1), killing the oldest distinct string each round\n";
+    std::cout << "  n = " << n << ":  " << perRound[0] * 1e9 << " ns/round\n";
+    std::cout << "  n = " << 4 * n << ": " << perRound[1] * 1e9 << " ns/round ("
+              << perRound[1] / perRound[0] << "x for 4x n)" << (same ? "" : "  MISMATCH") << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "queries") {
+        benchQueries(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000);
+        benchInterleaved(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000);
+        return 0;
+    }
+    if (argc > 1) {
+        benchStrings(std::strtoull(argv[1], nullptr, 10));
+        return 0;
+    }
+    benchStrings(100000);
+    benchStrings(5000000);
+    benchQueries(100000);
+    benchInterleaved(100000);
+    return 0;
+}
+#endif
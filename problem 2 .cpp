@@ -1,30 +1,349 @@
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+// ---- Row generation helpers
+namespace pascal {
+
+// Below this many entries one thread fills the whole row.
+const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+// Calls body(chunk, begin, end) on one contiguous chunk of [0, n) per
+// hardware thread and returns the number of chunks (1 for small n).
+template <typename Body>
+size_t parallelChunks(size_t n, Body&& body) {
+    size_t workers = n < PARALLEL_THRESHOLD ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    size_t chunk = std::max<size_t>(1, (n + workers - 1) / workers);
+    std::vector<std::thread> threads;
+    size_t used = 0;
+    for (size_t begin = chunk; begin < n; begin += chunk) {
+        threads.emplace_back(body, ++used, begin, std::min(n, begin + chunk));
+    }
+    body(size_t(0), size_t(0), std::min(n, chunk));
+    for (std::thread& t : threads) t.join();
+    return used + 1;
+}
+
+inline void checkIndex(int rowIndex) {
+    if (rowIndex < 0) throw std::invalid_argument("Row index must not be negative.");
+}
+
+// Rows are symmetric: compute entries 0..rowIndex/2, then mirror them.
+template <typename T>
+void mirror(std::vector<T>& row) {
+    for (size_t n = row.size() - 1, k = n / 2 + 1; k <= n; ++k) row[k] = row[n - k];
+}
+
+inline std::uint32_t mulMod(std::uint32_t a, std::uint32_t b, std::uint32_t p) {
+    return static_cast<std::uint32_t>(std::uint64_t(a) * b % p);
+}
+
+inline std::uint32_t powMod(std::uint32_t base, std::uint32_t exponent, std::uint32_t p) {
+    std::uint32_t result = 1 % p;
+    for (; exponent; exponent >>= 1, base = mulMod(base, base, p)) {
+        if (exponent & 1) result = mulMod(result, base, p);
+    }
+    return result;
+}
+
+inline bool isPrime(std::uint32_t p) {
+    if (p < 2) return false;
+    for (std::uint32_t d = 2; std::uint64_t(d) * d <= p; ++d) {
+        if (p % d == 0) return false;
+    }
+    return true;
+}
+
+// invFact[i] = 1 / i! mod p for i <= n (n < p). Filling it is a running
+// product from the top, so it is done in three steps: every chunk multiplies
+// its own range, the chunk products are chained into suffix products, and
+// every chunk then fills its range starting from its own suffix.
+inline std::vector<std::uint32_t> inverseFactorials(std::uint32_t n, std::uint32_t p) {
+    std::vector<std::uint32_t> invFact(size_t(n) + 1);
+    std::vector<std::uint32_t> partial(std::max(1u, std::thread::hardware_concurrency()) + 1, 1);
+    size_t chunks = parallelChunks(invFact.size(), [&](size_t chunk, size_t begin, size_t end) {
+        std::uint32_t product = 1;
+        for (size_t i = std::max<size_t>(begin, 1); i < end; ++i) product = mulMod(product, std::uint32_t(i), p);
+        partial[chunk] = product;
+    });
+    std::uint32_t fact = 1;
+    std::vector<std::uint32_t> suffix(chunks, 1); // product of the ranges after chunk c
+    for (size_t c = 0; c < chunks; ++c) fact = mulMod(fact, partial[c], p);
+    for (size_t c = chunks - 1; c-- > 0;) suffix[c] = mulMod(suffix[c + 1], partial[c + 1], p);
+    const std::uint32_t invN = powMod(fact, p - 2, p);
+    parallelChunks(invFact.size(), [&](size_t chunk, size_t begin, size_t end) {
+        std::uint32_t value = mulMod(invN, suffix[chunk], p); // 1 / (end - 1)!
+        for (size_t i = end; i-- > begin;) {
+            invFact[i] = value;
+            value = mulMod(value, std::uint32_t(std::max<size_t>(i, 1)), p);
+        }
+    });
+    return invFact;
+}
+
+} // namespace pascal
+
+// A non-negative integer of any size, just big enough for Pascal rows:
+// multiplying and exactly dividing by a machine word and printing.
+class BigNatural {
+private:
+    std::vector<std::uint64_t> limbs; // little-endian, no leading zero limbs; empty = 0
+
+public:
+    BigNatural(std::uint64_t value = 0) {
+        if (value) limbs.push_back(value);
+    }
+
+    BigNatural& operator*=(std::uint64_t m) {
+        unsigned __int128 carry = 0;
+        for (std::uint64_t& limb : limbs) {
+            carry += static_cast<unsigned __int128>(limb) * m;
+            limb = static_cast<std::uint64_t>(carry);
+            carry >>= 64;
+        }
+        if (carry) limbs.push_back(static_cast<std::uint64_t>(carry));
+        if (m == 0) limbs.clear();
+        return *this;
+    }
+
+    // Divides in place and returns the remainder.
+    std::uint64_t divide(std::uint64_t d) {
+        unsigned __int128 rem = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            unsigned __int128 cur = (rem << 64) | limbs[i];
+            limbs[i] = static_cast<std::uint64_t>(cur / d);
+            rem = cur % d;
+        }
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+        return static_cast<std::uint64_t>(rem);
+    }
+
+    size_t limbCount() const { return limbs.size(); }
+
+    friend bool operator==(const BigNatural& a, const BigNatural& b) { return a.limbs == b.limbs; }
+    friend bool operator!=(const BigNatural& a, const BigNatural& b) { return !(a == b); }
+
+    std::string toString() const {
+        if (limbs.empty()) return "0";
+        const std::uint64_t BASE = 10000000000000000000ull; // 10^19
+        BigNatural rest = *this;
+        std::vector<std::uint64_t> groups;
+        while (!rest.limbs.empty()) groups.push_back(rest.divide(BASE));
+        std::string digits = std::to_string(groups.back());
+        for (size_t i = groups.size() - 1; i-- > 0;) {
+            std::string group = std::to_string(groups[i]);
+            digits.append(19 - group.size(), '0').append(group);
+        }
+        return digits;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BigNatural& value) {
+        return os << value.toString();
+    }
+};
+
+// Row rowIndex of Pascal's triangle in O(n) with the multiplicative
+// recurrence C(n, k+1) = C(n, k) * (n - k) / (k + 1). Rows past 33 do not
+// fit in int and throw std::overflow_error; use getRowExact for those.
 std::vector<int> getRow(int rowIndex) {
+    pascal::checkIndex(rowIndex);
+    if (rowIndex > 33) throw std::overflow_error("Pascal row " + std::to_string(rowIndex) + " overflows int.");
     std::vector<int> f(rowIndex + 1, 1);
-    for (int i = 2; i < rowIndex + 1; ++i) {
-        for (int j = i - 1; j > 0; --j) {
-            f[j] += f[j - 1];
-        }
+    std::uint64_t value = 1;
+    for (int k = 0; k < rowIndex / 2; ++k) {
+        value = value * (rowIndex - k) / (k + 1); // exact: C(n, k) * (n - k) is divisible by k + 1
+        f[k + 1] = static_cast<int>(value);
     }
+    pascal::mirror(f);
     return f;
 }
 
+// Exact row of any size. Each step multiplies and divides by a word, so the
+// row costs O(n) word operations per limb of its largest entry.
+std::vector<BigNatural> getRowExact(int rowIndex) {
+    pascal::checkIndex(rowIndex);
+    std::vector<BigNatural> row(size_t(rowIndex) + 1);
+    BigNatural value = 1;
+    row[0] = value;
+    for (int k = 0; k < rowIndex / 2; ++k) {
+        value *= std::uint64_t(rowIndex - k);
+        value.divide(std::uint64_t(k) + 1);
+        row[k + 1] = value;
+    }
+    pascal::mirror(row);
+    return row;
+}
+
+// Row modulo a prime p. For rowIndex < p each entry is
+// n! * invFact[k] * invFact[n - k], from one inverse-factorial table built
+// and used in parallel chunks. Larger rows use Lucas' theorem on tables of
+// size p. Throws std::invalid_argument if p is not prime.
+std::vector<std::uint32_t> getRow(int rowIndex, std::uint32_t prime) {
+    pascal::checkIndex(rowIndex);
+    if (!pascal::isPrime(prime)) throw std::invalid_argument(std::to_string(prime) + " is not prime.");
+    const std::uint32_t n = static_cast<std::uint32_t>(rowIndex), p = prime;
+    std::vector<std::uint32_t> row(size_t(n) + 1);
+    const size_t half = n / 2 + 1;
+
+    if (n < p) {
+        std::vector<std::uint32_t> invFact = pascal::inverseFactorials(n, p);
+        const std::uint32_t factN = pascal::powMod(invFact[n], p - 2, p);
+        pascal::parallelChunks(half, [&](size_t, size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                row[k] = pascal::mulMod(pascal::mulMod(factN, invFact[k], p), invFact[n - k], p);
+            }
+        });
+    } else {
+        // Lucas: C(n, k) = prod C(n_i, k_i) over the base-p digits of n and k.
+        std::vector<std::uint32_t> invFact = pascal::inverseFactorials(p - 1, p);
+        std::vector<std::uint32_t> fact(p);
+        fact[0] = 1;
+        for (std::uint32_t i = 1; i < p; ++i) fact[i] = pascal::mulMod(fact[i - 1], i, p);
+        auto small = [&](std::uint32_t a, std::uint32_t b) -> std::uint32_t {
+            return b > a ? 0 : pascal::mulMod(pascal::mulMod(fact[a], invFact[b], p), invFact[a - b], p);
+        };
+        pascal::parallelChunks(half, [&](size_t, size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                std::uint32_t value = 1 % p;
+                for (std::uint32_t a = n, b = std::uint32_t(k); value && (a || b); a /= p, b /= p) {
+                    value = pascal::mulMod(value, small(a % p, b % p), p);
+                }
+                row[k] = value;
+            }
+        });
+    }
+    pascal::mirror(row);
+    return row;
+}
+
+// Floating-point row (double or long double) by the multiplicative
+// recurrence. Entries beyond the type's range are +infinity; once the
+// recurrence reaches it, the rest of the half row is filled in parallel.
+template <typename Real>
+std::vector<Real> getRowFloating(int rowIndex) {
+    static_assert(std::is_floating_point_v<Real>, "getRowFloating needs a floating-point type");
+    pascal::checkIndex(rowIndex);
+    std::vector<Real> row(size_t(rowIndex) + 1);
+    const size_t half = size_t(rowIndex) / 2 + 1;
+    Real value = 1;
+    size_t k = 0;
+    for (; k < half && value != std::numeric_limits<Real>::infinity(); ++k) {
+        row[k] = value;
+        // Ratio first: (n - k) / (k + 1) >= 1 on the half row, so the product
+        // only overflows when the true entry does.
+        value = value * ((Real(rowIndex) - Real(k)) / Real(k + 1));
+    }
+    const size_t finite = k;
+    pascal::parallelChunks(half - finite, [&](size_t, size_t begin, size_t end) {
+        std::fill(row.begin() + finite + begin, row.begin() + finite + end, std::numeric_limits<Real>::infinity());
+    });
+    pascal::mirror(row);
+    return row;
+}
+
+#ifndef BENCHMARK
 int main() {
     int rowIndex;
     std::cout << "Enter the row index: ";
     std::cin >> rowIndex;
 
-    std::vector<int> row = getRow(rowIndex);
     std::cout << "The " << rowIndex << "-th row of Pascal's Triangle is: [";
-    for (size_t i = 0; i < row.size(); ++i) {
-        std::cout << row[i];
-        if (i < row.size() - 1) {
-            std::cout << ", ";
+    auto print = [](const auto& row) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            std::cout << row[i];
+            if (i < row.size() - 1) {
+                std::cout << ", ";
+            }
         }
+    };
+    if (rowIndex <= 33) {
+        print(getRow(rowIndex));
+    } else {
+        print(getRowExact(rowIndex)); // too large for int
     }
     std::cout << "]" << std::endl;
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -pthread -DBENCHMARK "problem 2 .cpp" && ./a.out [max row]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// The original O(n^2) in-place update (overflows past row 33; only timed).
+std::vector<int> legacyGetRow(int rowIndex) {
+    std::vector<int> f(rowIndex + 1, 1);
+    for (int i = 2; i < rowIndex + 1; ++i) {
+        for (int j = i - 1; j > 0; --j) {
+            f[j] = static_cast<int>(static_cast<unsigned>(f[j]) + static_cast<unsigned>(f[j - 1]));
+        }
+    }
+    return f;
+}
+
+// getRowFloating<Real>(n) against the exact row: entries within the type's
+// range must match to a relative 1e-12 (rounding accumulates along the
+// recurrence), larger ones must be +infinity.
+template <typename Real>
+bool floatingRowMatches(int rowIndex) {
+    std::vector<BigNatural> exact = getRowExact(rowIndex);
+    std::vector<Real> row = getRowFloating<Real>(rowIndex);
+    const long double largest = std::numeric_limits<Real>::max();
+    for (size_t k = 0; k < exact.size(); ++k) {
+        long double expected = std::strtold(exact[k].toString().c_str(), nullptr);
+        long double actual = row[k];
+        bool ok = expected > largest * (1 - 1e-12L)
+                      ? actual == std::numeric_limits<Real>::infinity() || expected <= largest
+                      : std::fabs(actual - expected) <= expected * 1e-12L;
+        if (!ok) {
+            std::cout << "  row " << rowIndex << ", k = " << k << ": " << actual << " vs " << expected << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double seconds(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const int maxRow = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    const std::uint32_t MOD = 1000000007, SMALL_PRIME = 65521;
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::uint64_t sink = 0;
+    for (int n = 1000; n <= maxRow; n *= 10) {
+        std::cout << "row " << n << "\n";
+        auto row = [&](const char* label, double s) { std::cout << "  " << label << s * 1e3 << " ms\n"; };
+        if (n <= 100000) row("legacy O(n^2) int:        ", seconds([&] { sink += legacyGetRow(n)[n / 2]; }));
+        if (n <= 10000) row("getRowExact:              ", seconds([&] { sink += getRowExact(n)[n / 2].limbCount(); }));
+        row("getRow mod 1e9+7:         ", seconds([&] { sink += getRow(n, MOD)[n / 2]; }));
+        row("getRow mod 65521 (Lucas): ", seconds([&] { sink += getRow(n, SMALL_PRIME)[n / 3]; }));
+        row("getRowFloating<double>:   ", seconds([&] { sink += getRowFloating<double>(n)[n / 2] > 0; }));
+        row("getRowFloating<long dbl>: ", seconds([&] { sink += getRowFloating<long double>(n)[n / 2] > 0; }));
+    }
+    // Cross-check: the exact row reduced modulo the prime.
+    std::vector<BigNatural> exact = getRowExact(2000);
+    std::vector<std::uint32_t> modular = getRow(2000, MOD), lucas = getRow(2000, 1999);
+    bool same = true;
+    for (size_t k = 0; k < exact.size(); ++k) {
+        BigNatural a = exact[k], b = exact[k];
+        same = same && a.divide(MOD) == modular[k] && b.divide(1999) == lucas[k];
+    }
+    // Around and past the edge where C(n, n / 2) leaves double's range.
+    for (int n : {1020, 1029, 1030, 1100, 2000}) same = same && floatingRowMatches<double>(n);
+    same = same && floatingRowMatches<long double>(2000);
+    std::cout << (same ? "rows agree" : "MISMATCH") << " (sink " << sink << ")\n";
+    return 0;
+}
+#endif
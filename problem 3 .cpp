@@ -1,4 +1,9 @@
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 using namespace std;
@@ -12,39 +17,133 @@ struct ListNode {
     ListNode(int x, ListNode *next) : val(x), next(next) {}
 };
 
-// Function to create the spiral matrix
-vector<vector<int>> spiralMatrix(int m, int n, ListNode* head) {
-    vector<vector<int>> ans(m, vector<int>(n, -1)); // Initialize matrix with -1
-    int i = 0, j = 0, k = 0;
-    const int dirs[5] = {0, 1, 0, -1, 0}; // Directions for spiral movement
-    while (head) {
-        ans[i][j] = head->val;
-        head = head->next;
-        while (true) {
-            int x = i + dirs[k];
-            int y = j + dirs[k + 1];
-            if (x >= 0 && x < m && y >= 0 && y < n && ans[x][y] == -1) {
-                i = x;
-                j = y;
-                break;
-            }
-            k = (k + 1) % 4;
+// Forward iteration over a linked list, so a list can be passed wherever a
+// range is expected.
+struct ListRange {
+    struct iterator {
+        ListNode* node;
+        int operator*() const { return node->val; }
+        iterator& operator++() {
+            node = node->next;
+            return *this;
         }
+        bool operator==(const iterator& other) const { return node == other.node; }
+        bool operator!=(const iterator& other) const { return node != other.node; }
+    };
+    ListNode* head;
+    iterator begin() const { return {head}; }
+    iterator end() const { return {nullptr}; }
+};
+
+// Row-major m x n matrix in a single allocation.
+struct Grid {
+    int rows = 0, cols = 0;
+    vector<int> cells;
+
+    Grid(int m, int n, int fill) : rows(max(m, 0)), cols(max(n, 0)), cells(size_t(rows) * cols, fill) {}
+
+    int& operator()(int i, int j) { return cells[size_t(i) * cols + j]; }
+    const int& operator()(int i, int j) const { return cells[size_t(i) * cols + j]; }
+};
+
+// Writes up to count values from [it, end) to cells[index], cells[index +
+// step], ...; returns false once the input runs out. The index only moves
+// between writes, so it never leaves the grid.
+template <typename It, typename End>
+bool fillRun(vector<int>& cells, ptrdiff_t index, ptrdiff_t step, int count, It& it, const End& end) {
+    for (; count > 0; --count, ++it) {
+        if (it == end) return false;
+        cells[size_t(index)] = *it;
+        if (count > 1) index += step;
+    }
+    return true;
+}
+
+// Function to create the spiral matrix. Cells are written layer by layer:
+// each layer is four straight runs (right, down, left, up) whose index
+// ranges are known in advance, so no cell is probed twice. Unfilled cells
+// stay -1 and values beyond m * n are ignored. Accepts any range of ints.
+template <typename Range>
+Grid spiralMatrix(int m, int n, const Range& values) {
+    Grid ans(m, n, -1);
+    auto it = std::begin(values);
+    auto end = std::end(values);
+    const ptrdiff_t stride = ans.cols;
+    // An empty run (e.g. the right column of a 1 x n grid) starts outside
+    // the grid, so it is skipped before its start index is used.
+    auto run = [&](int i, int j, ptrdiff_t step, int count) {
+        return count <= 0 || fillRun(ans.cells, i * stride + j, step, count, it, end);
+    };
+    for (int top = 0, bottom = ans.rows - 1, left = 0, right = ans.cols - 1; top <= bottom && left <= right;
+         ++top, --bottom, ++left, --right) {
+        if (!run(top, left, 1, right - left + 1)) break;                // top row, left to right
+        if (!run(top + 1, right, stride, bottom - top)) break;          // right column, downwards
+        if (top == bottom || left == right) break;                      // a single row or column
+        if (!run(bottom, right - 1, -1, right - left)) break;           // bottom row, right to left
+        if (!run(bottom - 1, left, -stride, bottom - top - 1)) break;   // left column, upwards
     }
     return ans;
 }
 
+Grid spiralMatrix(int m, int n, ListNode* head) {
+    return spiralMatrix(m, n, ListRange{head});
+}
+
+// Hands out ListNodes from large blocks instead of one new per node; every
+// node is released at once when the arena is destroyed.
+static_assert(is_trivially_destructible_v<ListNode>, "arena nodes are never destroyed one by one");
+
+class ListNodeArena {
+private:
+    vector<unique_ptr<unsigned char[]>> blocks; // raw storage: nodes are built by make()
+    size_t used = 0, capacity = 0;
+
+public:
+    ListNodeArena() = default;
+    ListNodeArena(const ListNodeArena&) = delete;
+    ListNodeArena& operator=(const ListNodeArena&) = delete;
+
+    // Makes the next `count` nodes come from one block.
+    void reserve(size_t count) {
+        if (capacity - used >= count) return;
+        blocks.emplace_back(new unsigned char[count * sizeof(ListNode)]);
+        used = 0;
+        capacity = count;
+    }
+
+    ListNode* make(int val) {
+        if (used == capacity) reserve(max<size_t>(64, capacity * 2));
+        void* slot = blocks.back().get() + used++ * sizeof(ListNode);
+        return new (slot) ListNode(val); // ListNode is trivially destructible
+    }
+};
+
 // Helper function to create a linked list from a vector of values
 ListNode* createLinkedList(const vector<int>& values) {
+    if (values.empty()) return nullptr;
     ListNode* head = new ListNode(values[0]);
     ListNode* current = head;
-    for (int i = 1; i < values.size(); i++) {
+    for (size_t i = 1; i < values.size(); i++) {
         current->next = new ListNode(values[i]);
         current = current->next;
     }
     return head;
 }
 
+// Same list with every node taken from the arena (one allocation in total).
+ListNode* createLinkedList(const vector<int>& values, ListNodeArena& arena) {
+    if (values.empty()) return nullptr;
+    arena.reserve(values.size());
+    ListNode* head = arena.make(values[0]);
+    ListNode* current = head;
+    for (size_t i = 1; i < values.size(); i++) {
+        current->next = arena.make(values[i]);
+        current = current->next;
+    }
+    return head;
+}
+
+#ifndef BENCHMARK
 // Main function
 int main() {
     int m, n;
@@ -68,19 +167,124 @@ int main() {
     }
 
     // Create the linked list from input values
-    ListNode* head = createLinkedList(values);
+    ListNodeArena arena;
+    ListNode* head = createLinkedList(values, arena);
 
     // Generate the spiral matrix
-    vector<vector<int>> result = spiralMatrix(m, n, head);
+    Grid result = spiralMatrix(m, n, head);
 
     // Output the matrix
     cout << "\nGenerated " << m << " x " << n << " Matrix in Spiral Order:" << endl;
-    for (const auto& row : result) {
-        for (int val : row) {
-            cout << val << "\t"; // Print each element with a tab space
+    for (int i = 0; i < result.rows; i++) {
+        for (int j = 0; j < result.cols; j++) {
+            cout << result(i, j) << "\t"; // Print each element with a tab space
         }
         cout << endl;
     }
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -DBENCHMARK "problem 3 .cpp" && ./a.out [side]
+#include <chrono>
+#include <cstdlib>
+
+// The original sentinel-probing fill. Its probe loop never ends once the
+// last value is placed in a full grid; the `if (!head) break;` line is the
+// one change made so that it can be timed at all.
+vector<vector<int>> legacySpiralMatrix(int m, int n, ListNode* head) {
+    vector<vector<int>> ans(m, vector<int>(n, -1));
+    int i = 0, j = 0, k = 0;
+    const int dirs[5] = {0, 1, 0, -1, 0};
+    while (head) {
+        ans[i][j] = head->val;
+        head = head->next;
+        while (true) {
+            int x = i + dirs[k];
+            int y = j + dirs[k + 1];
+            if (x >= 0 && x < m && y >= 0 && y < n && ans[x][y] == -1) {
+                i = x;
+                j = y;
+                break;
+            }
+            k = (k + 1) % 4;
+            if (!head) break;
+        }
+    }
+    return ans;
+}
+
+template <typename F>
+double seconds(F&& body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void freeList(ListNode* head) {
+    while (head) {
+        ListNode* next = head->next;
+        delete head;
+        head = next;
+    }
+}
+
+// Every shape up to 6 x 6, including single rows and columns, with lists
+// from empty to full against the legacy fill (which cannot stop early), and
+// longer lists against the full one.
+bool shapesAgree() {
+    for (int m = 1; m <= 6; m++) {
+        for (int n = 1; n <= 6; n++) {
+            vector<int> values;
+            Grid full(0, 0, 0);
+            for (int length = 0; length <= m * n + 2; values.push_back(length++)) {
+                ListNode* head = createLinkedList(values);
+                Grid grid = spiralMatrix(m, n, head);
+                bool same;
+                if (length <= m * n) {
+                    vector<vector<int>> legacy = legacySpiralMatrix(m, n, head);
+                    same = true;
+                    for (int i = 0; i < m && same; i++) same = equal(legacy[i].begin(), legacy[i].end(), &grid(i, 0));
+                    if (length == m * n) full = grid;
+                } else {
+                    same = grid.cells == full.cells;
+                }
+                freeList(head);
+                if (!same) {
+                    cout << "  MISMATCH at " << m << " x " << n << ", " << length << " values" << endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const int side = argc > 1 ? atoi(argv[1]) : 1000;
+    cout << "  shapes 1 x 1 .. 6 x 6: " << (shapesAgree() ? "agree" : "MISMATCH") << endl;
+    vector<int> values(size_t(side) * side);
+    for (size_t i = 0; i < values.size(); i++) values[i] = int(i);
+    auto row = [](const char* label, double s) { cout << "  " << label << s * 1e3 << " ms" << endl; };
+    cout << side << " x " << side << " (" << values.size() << " values)" << endl;
+
+    ListNode* heap = nullptr;
+    row("createLinkedList (new per node):", seconds([&] { heap = createLinkedList(values); }));
+    ListNodeArena arena;
+    ListNode* pooled = nullptr;
+    row("createLinkedList (arena):       ", seconds([&] { pooled = createLinkedList(values, arena); }));
+
+    long long sink = 0;
+    vector<vector<int>> legacy;
+    Grid fromList(0, 0, 0), fromVector(0, 0, 0);
+    row("legacy spiralMatrix:            ", seconds([&] { legacy = legacySpiralMatrix(side, side, heap); }));
+    row("spiralMatrix(ListNode*):        ", seconds([&] { fromList = spiralMatrix(side, side, pooled); }));
+    row("spiralMatrix(vector<int>):      ", seconds([&] { fromVector = spiralMatrix(side, side, values); }));
+    bool same = fromList.cells == fromVector.cells;
+    for (int i = 0; i < side && same; i++) same = equal(legacy[i].begin(), legacy[i].end(), &fromList(i, 0));
+    sink += fromList(side / 2, side / 2);
+    row("freeing the new'd list:         ", seconds([&] { freeList(heap); }));
+    cout << "  " << (same ? "grids agree" : "MISMATCH") << " (sink " << sink << ")" << endl;
+    return 0;
+}
+#endif
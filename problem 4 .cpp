@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <numeric>
 #include <vector>
 
+#include "kernel_dispatch.h"
+
 using namespace std;
 
 // Function to check if two rectangles overlap
@@ -10,6 +15,256 @@ bool isRectangleOverlap(vector<int>& rec1, vector<int>& rec2) {
     return !(y3 >= y2 || y4 <= y1 || x3 >= x2 || x4 <= x1);
 }
 
+// ---- Many rectangles at once
+
+struct Rect {
+    int x1, y1, x2, y2; // bottom-left and top-right corners
+};
+
+// Same test as above: the intersection must have positive area.
+inline bool isRectangleOverlap(const Rect& a, const Rect& b) {
+    return b.x1 < a.x2 && b.x2 > a.x1 && b.y1 < a.y2 && b.y2 > a.y1;
+}
+
+// Rectangles stored column by column (structure of arrays), so a batch
+// kernel can load 8 left edges, 8 right edges, ... with one instruction each.
+struct RectangleSet {
+    vector<int> x1, y1, x2, y2;
+
+    size_t size() const { return x1.size(); }
+
+    void reserve(size_t n) {
+        x1.reserve(n), y1.reserve(n), x2.reserve(n), y2.reserve(n);
+    }
+
+    void push_back(const Rect& r) {
+        x1.push_back(r.x1), y1.push_back(r.y1), x2.push_back(r.x2), y2.push_back(r.y2);
+    }
+
+    Rect operator[](size_t i) const { return {x1[i], y1[i], x2[i], y2[i]}; }
+};
+
+// One rectangle against a run of columns. Each kernel writes the offsets of
+// the overlapping rectangles to hits (room for n entries) and returns how
+// many it wrote. kernels() picks the AVX2 version when the CPU has it.
+namespace rectKernels {
+
+struct Kernels {
+    size_t (*overlapping)(const int* x1, const int* y1, const int* x2, const int* y2, size_t n, const Rect& q,
+                          uint32_t* hits);
+};
+
+inline size_t overlappingPortable(const int* x1, const int* y1, const int* x2, const int* y2, size_t n,
+                                  const Rect& q, uint32_t* hits) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        hits[count] = static_cast<uint32_t>(i);
+        count += (x1[i] < q.x2) & (x2[i] > q.x1) & (y1[i] < q.y2) & (y2[i] > q.y1); // branch-free
+    }
+    return count;
+}
+
+#ifdef KERNEL_DISPATCH_X86
+
+__attribute__((target("avx2"))) inline __m256i load8(const int* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2,bmi"))) inline size_t overlappingAvx2(const int* x1, const int* y1, const int* x2,
+                                                                  const int* y2, size_t n, const Rect& q,
+                                                                  uint32_t* hits) {
+    const __m256i qx1 = _mm256_set1_epi32(q.x1), qy1 = _mm256_set1_epi32(q.y1);
+    const __m256i qx2 = _mm256_set1_epi32(q.x2), qy2 = _mm256_set1_epi32(q.y2);
+    size_t count = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i inX = _mm256_and_si256(_mm256_cmpgt_epi32(qx2, load8(x1 + i)), _mm256_cmpgt_epi32(load8(x2 + i), qx1));
+        __m256i inY = _mm256_and_si256(_mm256_cmpgt_epi32(qy2, load8(y1 + i)), _mm256_cmpgt_epi32(load8(y2 + i), qy1));
+        __m256i hit = _mm256_and_si256(inX, inY);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+        for (; mask; mask = _blsr_u32(mask)) hits[count++] = static_cast<uint32_t>(i + _tzcnt_u32(mask));
+    }
+    for (; i < n; ++i) {
+        hits[count] = static_cast<uint32_t>(i);
+        count += (x1[i] < q.x2) & (x2[i] > q.x1) & (y1[i] < q.y2) & (y2[i] > q.y1);
+    }
+    return count;
+}
+
+#endif // KERNEL_DISPATCH_X86
+
+using kernel_dispatch::Level;
+
+inline Kernels kernelsFor(Level level) {
+    return kernel_dispatch::select<Kernels>(level, {
+#ifdef KERNEL_DISPATCH_X86
+        {Level::AVX2, kernel_dispatch::AVX2 | kernel_dispatch::BMI, {overlappingAvx2}},
+#endif
+        {Level::Portable, kernel_dispatch::NONE, {overlappingPortable}},
+    });
+}
+
+inline const Kernels& kernels() { return kernel_dispatch::best<Kernels, kernelsFor>(); }
+
+// Rectangles tested per kernel call (and hit buffer size) in the loops below.
+const size_t BLOCK = 256;
+
+} // namespace rectKernels
+
+// Calls onHit(i) for every rectangle i of set that overlaps q.
+template <typename OnHit>
+void forEachOverlapping(const RectangleSet& set, const Rect& q, OnHit&& onHit) {
+    const auto& k = rectKernels::kernels();
+    uint32_t hits[rectKernels::BLOCK];
+    for (size_t begin = 0; begin < set.size(); begin += rectKernels::BLOCK) {
+        size_t n = min(rectKernels::BLOCK, set.size() - begin);
+        size_t found = k.overlapping(&set.x1[begin], &set.y1[begin], &set.x2[begin], &set.y2[begin], n, q, hits);
+        for (size_t h = 0; h < found; ++h) onHit(begin + hits[h]);
+    }
+}
+
+// Calls onPair(i, j), i < j, for every overlapping pair. Sweep line: the
+// rectangles are visited by left edge, each one is tested (in batches)
+// against the active list of earlier rectangles, then joins it. Entries
+// whose right edge is left of the sweep can never overlap again and are
+// compacted away every so often, so the active list stays about as long as
+// the number of rectangles crossing the sweep line.
+template <typename OnPair>
+void forEachOverlappingPair(const RectangleSet& rects, OnPair&& onPair) {
+    const auto& k = rectKernels::kernels();
+    vector<uint32_t> order(rects.size());
+    iota(order.begin(), order.end(), 0u);
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return rects.x1[a] < rects.x1[b]; });
+
+    RectangleSet active;
+    vector<uint32_t> activeIds;
+    uint32_t hits[rectKernels::BLOCK];
+    size_t sinceCompaction = 0;
+    for (uint32_t id : order) {
+        const Rect r = rects[id];
+        if (++sinceCompaction > active.size() / 2 + 16) {
+            size_t live = 0;
+            for (size_t i = 0; i < active.size(); ++i) {
+                if (active.x2[i] <= r.x1) continue; // ended before the sweep
+                active.x1[live] = active.x1[i], active.y1[live] = active.y1[i];
+                active.x2[live] = active.x2[i], active.y2[live] = active.y2[i];
+                activeIds[live++] = activeIds[i];
+            }
+            active.x1.resize(live), active.y1.resize(live), active.x2.resize(live), active.y2.resize(live);
+            activeIds.resize(live);
+            sinceCompaction = 0;
+        }
+        for (size_t begin = 0; begin < active.size(); begin += rectKernels::BLOCK) {
+            size_t n = min(rectKernels::BLOCK, active.size() - begin);
+            size_t found =
+                k.overlapping(&active.x1[begin], &active.y1[begin], &active.x2[begin], &active.y2[begin], n, r, hits);
+            for (size_t h = 0; h < found; ++h) {
+                uint32_t other = activeIds[begin + hits[h]];
+                onPair(min(other, id), max(other, id));
+            }
+        }
+        active.push_back(r);
+        activeIds.push_back(id);
+    }
+}
+
+// Static packed R-tree for window queries. Rectangles are sorted along a
+// Hilbert curve through their centres and grouped NODE at a time; each
+// level above stores the bounding boxes of NODE consecutive entries of the
+// level below, in the same column layout, so a node's children are tested
+// with one kernel call.
+class RectangleIndex {
+public:
+    static const size_t NODE = 16;
+
+private:
+    vector<RectangleSet> levels; // levels[0]: the rectangles; back(): at most NODE root boxes
+    vector<uint32_t> ids;        // levels[0] position -> index in the input set
+
+    // Position of (x, y) on a Hilbert curve filling a 65536 x 65536 grid.
+    static uint64_t hilbert(uint32_t x, uint32_t y) {
+        const uint32_t side = 1u << 16;
+        uint64_t d = 0;
+        for (uint32_t s = side / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) ? 1 : 0, ry = (y & s) ? 1 : 0;
+            d += uint64_t(s) * s * ((3 * rx) ^ ry);
+            if (ry == 0) { // rotate the quadrant so the curve stays continuous
+                if (rx == 1) x = side - 1 - x, y = side - 1 - y;
+                swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    template <typename OnHit>
+    void visit(size_t level, size_t begin, size_t end, const Rect& q, OnHit& onHit) const {
+        const RectangleSet& boxes = levels[level];
+        uint32_t hits[NODE];
+        size_t found = rectKernels::kernels().overlapping(&boxes.x1[begin], &boxes.y1[begin], &boxes.x2[begin],
+                                                          &boxes.y2[begin], end - begin, q, hits);
+        for (size_t h = 0; h < found; ++h) {
+            size_t entry = begin + hits[h];
+            if (level == 0) {
+                onHit(ids[entry]);
+            } else {
+                visit(level - 1, entry * NODE, min((entry + 1) * NODE, levels[level - 1].size()), q, onHit);
+            }
+        }
+    }
+
+public:
+    explicit RectangleIndex(const RectangleSet& rects) {
+        const size_t n = rects.size();
+        if (n == 0) return;
+        // Scale centres onto the 16-bit Hilbert grid.
+        int64_t minX = INT64_MAX, minY = INT64_MAX, maxX = INT64_MIN, maxY = INT64_MIN;
+        vector<int64_t> cx(n), cy(n);
+        for (size_t i = 0; i < n; ++i) {
+            cx[i] = (int64_t(rects.x1[i]) + rects.x2[i]) / 2, cy[i] = (int64_t(rects.y1[i]) + rects.y2[i]) / 2;
+            minX = min(minX, cx[i]), maxX = max(maxX, cx[i]), minY = min(minY, cy[i]), maxY = max(maxY, cy[i]);
+        }
+        vector<pair<uint64_t, uint32_t>> keyed(n);
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t hx = uint32_t((cx[i] - minX) * 65535 / max<int64_t>(1, maxX - minX));
+            uint32_t hy = uint32_t((cy[i] - minY) * 65535 / max<int64_t>(1, maxY - minY));
+            keyed[i] = {hilbert(hx, hy), uint32_t(i)};
+        }
+        sort(keyed.begin(), keyed.end());
+
+        levels.emplace_back();
+        levels[0].reserve(n);
+        ids.reserve(n);
+        for (const auto& [key, id] : keyed) {
+            levels[0].push_back(rects[id]);
+            ids.push_back(id);
+        }
+        while (levels.back().size() > NODE) {
+            const RectangleSet& below = levels.back();
+            RectangleSet above;
+            above.reserve((below.size() + NODE - 1) / NODE);
+            for (size_t begin = 0; begin < below.size(); begin += NODE) {
+                size_t end = min(begin + NODE, below.size());
+                Rect box = below[begin];
+                for (size_t i = begin + 1; i < end; ++i) {
+                    box.x1 = min(box.x1, below.x1[i]), box.y1 = min(box.y1, below.y1[i]);
+                    box.x2 = max(box.x2, below.x2[i]), box.y2 = max(box.y2, below.y2[i]);
+                }
+                above.push_back(box);
+            }
+            levels.push_back(move(above));
+        }
+    }
+
+    size_t size() const { return ids.size(); }
+
+    // Calls onHit(i) for every indexed rectangle i that overlaps window.
+    template <typename OnHit>
+    void query(const Rect& window, OnHit&& onHit) const {
+        if (levels.empty()) return;
+        visit(levels.size() - 1, 0, levels.back().size(), window, onHit);
+    }
+};
+
+#ifndef BENCHMARK
 int main() {
     vector<int> rec1(4), rec2(4);
 
@@ -30,3 +285,104 @@ int main() {
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -DBENCHMARK "problem 4 .cpp" && ./a.out [rectangles]
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <random>
+
+template <typename F>
+double seconds(F&& body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// n rectangles in a 2^24 square, sized so each overlaps a few others.
+RectangleSet randomRectangles(size_t n, uint64_t seed) {
+    mt19937_64 rng(seed);
+    const int world = 1 << 24;
+    const int maxSide = max(2, int(world / sqrt(double(n)) * 1.5));
+    RectangleSet rects;
+    rects.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        int x = int(rng() % world), y = int(rng() % world);
+        rects.push_back({x, y, x + 1 + int(rng() % maxSide), y + 1 + int(rng() % maxSide)});
+    }
+    return rects;
+}
+
+// Returns false, after saying so, if the methods disagree on a count.
+bool benchRectangles(size_t n) {
+    RectangleSet rects = randomRectangles(n, n);
+    auto row = [](const char* label, double s, size_t count) {
+        cout << "  " << label << s * 1e3 << " ms (" << count << ")" << endl;
+    };
+    cout << "n = " << n << endl;
+
+    vector<size_t> pairCounts; // every method that ran, all counting the same pairs
+    if (n <= 10000) {
+        vector<vector<int>> legacy(n, vector<int>(4));
+        for (size_t i = 0; i < n; ++i) legacy[i] = {rects.x1[i], rects.y1[i], rects.x2[i], rects.y2[i]};
+        size_t count = 0;
+        double s = seconds([&] {
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = i + 1; j < n; ++j) count += isRectangleOverlap(legacy[i], legacy[j]);
+            }
+        });
+        row("legacy all pairs O(n^2):       ", s, count);
+        pairCounts.push_back(count);
+    }
+    if (n <= 100000) {
+        size_t count = 0;
+        double s = seconds([&] {
+            for (size_t i = 0; i < n; ++i) forEachOverlapping(rects, rects[i], [&](size_t j) { count += j > i; });
+        });
+        row("batch kernel all pairs O(n^2): ", s, count);
+        pairCounts.push_back(count);
+    }
+    size_t pairs = 0;
+    double sweep = seconds([&] { forEachOverlappingPair(rects, [&](uint32_t, uint32_t) { ++pairs; }); });
+    row("sweep line all pairs:          ", sweep, pairs);
+    pairCounts.push_back(pairs);
+
+    optional<RectangleIndex> index;
+    double build = seconds([&] { index.emplace(rects); });
+    row("R-tree build:                  ", build, index->size());
+    size_t selfJoin = 0;
+    double join = seconds([&] {
+        for (size_t i = 0; i < n; ++i) index->query(rects[i], [&](uint32_t j) { selfJoin += j > i; });
+    });
+    row("R-tree self-join all pairs:    ", join, selfJoin);
+    pairCounts.push_back(selfJoin);
+
+    RectangleSet windows = randomRectangles(10000, n + 1);
+    size_t hits = 0, scanned = 0, indexedHits = 0;
+    double queries = seconds([&] {
+        for (size_t w = 0; w < windows.size(); ++w) index->query(windows[w], [&](uint32_t) { ++hits; });
+    });
+    row("R-tree 10^4 window queries:    ", queries, hits);
+    double scan = seconds([&] {
+        for (size_t w = 0; w < 100; ++w) forEachOverlapping(rects, windows[w], [&](size_t) { ++scanned; });
+    });
+    row("batch kernel 10^2 windows:     ", scan, scanned);
+    for (size_t w = 0; w < 100; ++w) index->query(windows[w], [&](uint32_t) { ++indexedHits; });
+
+    bool pairsAgree = all_of(pairCounts.begin(), pairCounts.end(), [&](size_t c) { return c == pairs; });
+    if (!pairsAgree || indexedHits != scanned) {
+        cerr << "MISMATCH at n = " << n << ": pair counts";
+        for (size_t c : pairCounts) cerr << " " << c;
+        cerr << "; R-tree " << indexedHits << " vs scan " << scanned << " hits in 10^2 windows" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) return benchRectangles(strtoull(argv[1], nullptr, 10)) ? 0 : 1;
+    bool ok = benchRectangles(10000) && benchRectangles(100000) && benchRectangles(1000000);
+    return ok ? 0 : 1;
+}
+#endif
@@ -1,36 +1,262 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "kernel_dispatch.h"
+
+// The carry chain below needs 64-bit adc, so only x86-64 takes the SIMD path.
+#if defined(KERNEL_DISPATCH_X86) && defined(__x86_64__)
+#define BINARY_X86 1
+#endif
 
 using namespace std;
 
-// Function to add two binary numbers
-string addBinary(string a, string b) {
-    string result = "";  // To store the result
-    int carry = 0;       // To store carry value
-    int i = a.size() - 1, j = b.size() - 1;
+// ---- Bit-string <-> 64-bit limb conversion
+//
+// A limb is 64 characters of the bit string, most significant first. Each
+// conversion has a SWAR/table version and an AVX2 version that handles 32
+// characters per instruction; kernels() picks once per process.
+namespace binaryKernels {
 
-    // Iterate from the end of both strings
-    while (i >= 0 || j >= 0 || carry) {
-        int sum = carry;
+struct Kernels {
+    // Packs count limbs; limb i comes from the 64 characters ending 64 * i
+    // before end. Returns false if any character is not '0' or '1'.
+    bool (*parse)(const char* end, size_t count, uint64_t* limbs);
+    // Writes limbs[count - 1] down to limbs[0] as count * 64 characters.
+    void (*format)(const uint64_t* limbs, size_t count, char* out);
+};
 
-        if (i >= 0) {
-            sum += a[i] - '0';  // Convert char to int
-            i--;
+// 8 characters -> 1 byte. After xor with '0' every valid byte is 0 or 1;
+// the multiply moves bit 0 of byte i to bit 63 - i, and nothing else lands
+// in the top byte or carries into it.
+inline bool parse8(const char* p, uint64_t& byte) {
+    uint64_t word;
+    memcpy(&word, p, 8);
+    word ^= 0x3030303030303030ull;
+    if (word & ~0x0101010101010101ull) return false;
+    byte = (word * 0x8040201008040201ull) >> 56;
+    return true;
+}
+
+// Byte value -> its 8 characters, most significant bit first.
+inline const array<uint64_t, 256>& byteChars() {
+    static const array<uint64_t, 256> table = [] {
+        array<uint64_t, 256> t{};
+        for (int v = 0; v < 256; ++v) {
+            char chars[8];
+            for (int bit = 0; bit < 8; ++bit) chars[bit] = ((v >> (7 - bit)) & 1) ? '1' : '0';
+            memcpy(&t[v], chars, 8);
         }
-        if (j >= 0) {
-            sum += b[j] - '0';  // Convert char to int
-            j--;
+        return t;
+    }();
+    return table;
+}
+
+inline bool parsePortable(const char* end, size_t count, uint64_t* limbs) {
+    for (size_t i = 0; i < count; ++i) {
+        const char* p = end - 64 * (i + 1);
+        uint64_t limb = 0;
+        for (int k = 0; k < 8; ++k) {
+            uint64_t byte;
+            if (!parse8(p + 8 * k, byte)) return false;
+            limb = (limb << 8) | byte;
         }
+        limbs[i] = limb;
+    }
+    return true;
+}
 
-        result += (sum % 2) + '0';  // Append the binary result of sum % 2
-        carry = sum / 2;            // Update the carry
+inline void formatPortable(const uint64_t* limbs, size_t count, char* out) {
+    const auto& table = byteChars();
+    for (size_t i = count; i-- > 0; out += 64) {
+        for (int k = 0; k < 8; ++k) memcpy(out + 8 * k, &table[(limbs[i] >> (56 - 8 * k)) & 0xFF], 8);
     }
+}
 
-    reverse(result.begin(), result.end());  // Reverse to get correct order
-    return result;
+#ifdef BINARY_X86
+
+// 32 characters -> 32 bits, first character in bit 31 (0xFFFFFFFF in
+// `valid` unless a character is not a digit 0/1).
+__attribute__((target("avx2"))) inline uint32_t parse32(const char* p, uint32_t& valid) {
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    chars = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(chars, reverse), 0x4E); // last character first
+    __m256i ones = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('1'));
+    __m256i zeros = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('0'));
+    valid &= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(ones, zeros)));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(ones));
+}
+
+// 32 bits -> 32 characters, bit 31 first.
+__attribute__((target("avx2"))) inline void format32(uint32_t bits, char* out) {
+    const __m256i spread = _mm256_setr_epi8(3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2,
+                                            1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i select = _mm256_set1_epi64x(0x0102040810204080ll);
+    __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)), spread);
+    __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+    __m256i chars = _mm256_sub_epi8(_mm256_set1_epi8('0'), set); // '0' - (-1) = '1'
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+}
+
+__attribute__((target("avx2"))) inline bool parseAvx2(const char* end, size_t count, uint64_t* limbs) {
+    uint32_t valid = 0xFFFFFFFFu;
+    for (size_t i = 0; i < count; ++i) {
+        const char* p = end - 64 * (i + 1);
+        uint64_t high = parse32(p, valid);
+        limbs[i] = (high << 32) | parse32(p + 32, valid);
+    }
+    return valid == 0xFFFFFFFFu;
+}
+
+__attribute__((target("avx2"))) inline void formatAvx2(const uint64_t* limbs, size_t count, char* out) {
+    for (size_t i = count; i-- > 0; out += 64) {
+        format32(static_cast<uint32_t>(limbs[i] >> 32), out);
+        format32(static_cast<uint32_t>(limbs[i]), out + 32);
+    }
+}
+
+#endif // BINARY_X86
+
+using kernel_dispatch::Level;
+
+inline Kernels kernelsFor(Level level) {
+    return kernel_dispatch::select<Kernels>(level, {
+#ifdef BINARY_X86
+        {Level::AVX2, kernel_dispatch::AVX2, {parseAvx2, formatAvx2}},
+#endif
+        {Level::Portable, kernel_dispatch::NONE, {parsePortable, formatPortable}},
+    });
+}
+
+inline const Kernels& kernels() { return kernel_dispatch::best<Kernels, kernelsFor>(); }
+
+// out[i] = a[i] + b[i] + carry for i < n; returns the final carry. On x86
+// this is one adc per limb.
+inline unsigned char addLimbs(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n, unsigned char carry) {
+    size_t i = 0;
+#ifdef BINARY_X86
+    unsigned long long r0, r1, r2, r3;
+    for (; i + 4 <= n; i += 4) {
+        carry = _addcarry_u64(carry, a[i], b[i], &r0);
+        carry = _addcarry_u64(carry, a[i + 1], b[i + 1], &r1);
+        carry = _addcarry_u64(carry, a[i + 2], b[i + 2], &r2);
+        carry = _addcarry_u64(carry, a[i + 3], b[i + 3], &r3);
+        out[i] = r0, out[i + 1] = r1, out[i + 2] = r2, out[i + 3] = r3;
+    }
+    for (; i < n; ++i) {
+        carry = _addcarry_u64(carry, a[i], b[i], &r0);
+        out[i] = r0;
+    }
+#else
+    for (; i < n; ++i) {
+        uint64_t sum;
+        unsigned char c1 = __builtin_add_overflow(a[i], b[i], &sum);
+        unsigned char c2 = __builtin_add_overflow(sum, uint64_t(carry), &out[i]);
+        carry = c1 | c2;
+    }
+#endif
+    return carry;
+}
+
+} // namespace binaryKernels
+
+// Non-negative integer stored as packed 64-bit limbs, least significant
+// first, with no leading zero limbs (zero has none).
+class BinaryInteger {
+private:
+    vector<uint64_t> limbs;
+
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+    }
+
+public:
+    BinaryInteger() = default;
+
+    explicit BinaryInteger(uint64_t value) {
+        if (value) limbs.push_back(value);
+    }
+
+    // Parses a string of '0' and '1', most significant bit first; the empty
+    // string is zero. Throws std::invalid_argument on any other character.
+    static BinaryInteger fromBits(string_view bits) {
+        BinaryInteger result;
+        const size_t full = bits.size() / 64, head = bits.size() % 64;
+        result.limbs.resize(full + (head ? 1 : 0));
+        bool ok = binaryKernels::kernels().parse(bits.data() + bits.size(), full, result.limbs.data());
+        uint64_t top = 0;
+        for (size_t i = 0; i < head; ++i) {
+            char c = bits[i];
+            ok = ok && (c == '0' || c == '1');
+            top = (top << 1) | uint64_t(c == '1');
+        }
+        if (!ok) throw invalid_argument("Not a binary number: characters must be 0 or 1.");
+        if (head) result.limbs[full] = top;
+        result.trim();
+        return result;
+    }
+
+    // Most significant bit first, no leading zeros ("0" for zero).
+    string toBits() const {
+        if (limbs.empty()) return "0";
+        const uint64_t top = limbs.back();
+        const int topBits = 64 - __builtin_clzll(top);
+        string bits(topBits + 64 * (limbs.size() - 1), '0');
+        for (int i = 0; i < topBits; ++i) bits[i] = char('0' + ((top >> (topBits - 1 - i)) & 1));
+        binaryKernels::kernels().format(limbs.data(), limbs.size() - 1, bits.data() + topBits);
+        return bits;
+    }
+
+    size_t bitLength() const { return limbs.empty() ? 0 : 64 * limbs.size() - __builtin_clzll(limbs.back()); }
+    size_t limbCount() const { return limbs.size(); }
+
+    BinaryInteger& operator+=(const BinaryInteger& other) {
+        if (limbs.size() < other.limbs.size()) limbs.resize(other.limbs.size(), 0);
+        const size_t common = other.limbs.size();
+        unsigned char carry = binaryKernels::addLimbs(limbs.data(), other.limbs.data(), limbs.data(), common, 0);
+        for (size_t i = common; carry && i < limbs.size(); ++i) carry = ++limbs[i] == 0;
+        if (carry) limbs.push_back(1);
+        return *this;
+    }
+
+    // One pass over both operands straight into the result.
+    friend BinaryInteger operator+(const BinaryInteger& a, const BinaryInteger& b) {
+        const BinaryInteger& longer = a.limbs.size() >= b.limbs.size() ? a : b;
+        const BinaryInteger& shorter = &longer == &a ? b : a;
+        BinaryInteger sum;
+        sum.limbs.resize(longer.limbs.size() + 1);
+        const size_t common = shorter.limbs.size();
+        unsigned char carry =
+            binaryKernels::addLimbs(longer.limbs.data(), shorter.limbs.data(), sum.limbs.data(), common, 0);
+        for (size_t i = common; i < longer.limbs.size(); ++i) {
+            sum.limbs[i] = longer.limbs[i] + carry;
+            carry = carry && sum.limbs[i] == 0;
+        }
+        sum.limbs.back() = carry;
+        sum.trim();
+        return sum;
+    }
+
+    friend bool operator==(const BinaryInteger& a, const BinaryInteger& b) { return a.limbs == b.limbs; }
+    friend bool operator!=(const BinaryInteger& a, const BinaryInteger& b) { return !(a == b); }
+
+    friend ostream& operator<<(ostream& os, const BinaryInteger& value) { return os << value.toBits(); }
+};
+
+// Function to add two binary numbers. The result has no leading zeros
+// ("0" for zero); throws std::invalid_argument if an input is not binary.
+string addBinary(string_view a, string_view b) {
+    return (BinaryInteger::fromBits(a) + BinaryInteger::fromBits(b)).toBits();
 }
 
+#ifndef BENCHMARK
 // Main function
 int main() {
     string binary1, binary2;
@@ -44,7 +270,13 @@ int main() {
     cin >> binary2;
 
     // Perform binary addition
-    string sum = addBinary(binary1, binary2);
+    string sum;
+    try {
+        sum = addBinary(binary1, binary2);
+    } catch (const invalid_argument& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
 
     // Output result with comments
     cout << "\n=== Result ===" << endl;
@@ -53,3 +285,70 @@ int main() {
 
     return 0;
 }
+#else
+// g++ -std=c++20 -O2 -DBENCHMARK "problem 5 .cpp" && ./a.out [bits]
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+// The original char-per-bit addition.
+string legacyAddBinary(string a, string b) {
+    string result = "";
+    int carry = 0;
+    int i = a.size() - 1, j = b.size() - 1;
+    while (i >= 0 || j >= 0 || carry) {
+        int sum = carry;
+        if (i >= 0) sum += a[i--] - '0';
+        if (j >= 0) sum += b[j--] - '0';
+        result += (sum % 2) + '0';
+        carry = sum / 2;
+    }
+    reverse(result.begin(), result.end());
+    return result;
+}
+
+template <typename F>
+double bestSeconds(int repeats, F&& body) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void benchBits(size_t n) {
+    mt19937_64 rng(n);
+    string a(n, '0'), b(n, '0');
+    for (size_t i = 0; i < n; ++i) a[i] = char('0' + (rng() & 1)), b[i] = char('0' + (rng() & 1));
+    a[0] = b[0] = '1';
+    const int repeats = n >= 100000000 ? 1 : n >= 1000000 ? 5 : 2000;
+
+    auto row = [&](const char* label, double s) {
+        cout << "  " << label << s * 1e6 << " us, " << n / s / 1e9 << " Gbit/s" << endl;
+    };
+    cout << "n = " << n << " bits" << endl;
+    string legacy, packed;
+    row("legacy addBinary:     ", bestSeconds(repeats, [&] { legacy = legacyAddBinary(a, b); }));
+    row("addBinary (wrapper):  ", bestSeconds(repeats, [&] { packed = addBinary(a, b); }));
+    BinaryInteger x, y, z;
+    row("fromBits (per input): ", bestSeconds(repeats, [&] { x = BinaryInteger::fromBits(a); }));
+    y = BinaryInteger::fromBits(b);
+    row("operator+ (packed):   ", bestSeconds(repeats, [&] { z = x + y; }));
+    row("operator+= (packed):  ", bestSeconds(repeats, [&] { x += y; }));
+    row("toBits:               ", bestSeconds(repeats, [&] { packed = z.toBits(); }));
+    cout << "  " << (packed == legacy ? "results agree" : "MISMATCH") << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        benchBits(strtoull(argv[1], nullptr, 10));
+        return 0;
+    }
+    benchBits(1000);
+    benchBits(1000000);
+    benchBits(100000000);
+    return 0;
+}
+#endif